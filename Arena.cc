@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2013 Stephen Williams (steve@icarus.com)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+# include  "config.h"
+# include  "Arena.h"
+# include  <cstdlib>
+# include  <cstring>
+# include  <new>
+# include  <cassert>
+
+using namespace std;
+
+Arena pform_arena ("pform");
+Arena netlist_arena ("netlist");
+
+static arena_stats_t*stats_list = 0;
+
+arena_stats_t::arena_stats_t(const char*n)
+: name(n), count(0), bytes(0), peak_bytes(0), total_count(0), arena(0)
+{
+      next = stats_list;
+      stats_list = this;
+}
+
+static inline size_t round_up(size_t size, size_t align)
+{
+      return (size + align - 1) & ~(align - 1);
+}
+
+Arena::Arena(const char*name)
+: name_(name), blocks_(0), block_ptr_(0), block_rem_(0), big_(0), reserved_(0)
+{
+      memset(free_, 0, sizeof free_);
+}
+
+Arena::~Arena()
+{
+	/* Global arenas are destroyed at exit, and it is possible
+	   that some objects still refer to their memory then, so
+	   leave the memory to the system. */
+}
+
+void* Arena::alloc_small_(size_t size)
+{
+      if (block_rem_ < size) {
+	      /* Anything left in the current block is lost, but it
+		 is less than the largest small object. */
+	    block_t*blk = (block_t*) malloc(BLOCK_SIZE);
+	    if (blk == 0)
+		  throw std::bad_alloc();
+	    blk->next = blocks_;
+	    blocks_ = blk;
+	    reserved_ += BLOCK_SIZE;
+
+	    size_t hdr = round_up(sizeof(block_t), ALIGN);
+	    block_ptr_ = reinterpret_cast<char*>(blk) + hdr;
+	    block_rem_ = BLOCK_SIZE - hdr;
+      }
+
+      void*res = block_ptr_;
+      block_ptr_ += size;
+      block_rem_ -= size;
+      return res;
+}
+
+void* Arena::alloc(size_t size, arena_stats_t&stats)
+{
+      if (stats.arena == 0)
+	    stats.arena = this;
+      assert(stats.arena == this);
+
+      stats.count += 1;
+      stats.total_count += 1;
+      stats.bytes += size;
+      if (stats.bytes > stats.peak_bytes)
+	    stats.peak_bytes = stats.bytes;
+
+      if (size == 0)
+	    size = 1;
+
+      if (size > SMALL_MAX) {
+	    size_t hdr = round_up(sizeof(big_t), ALIGN);
+	    big_t*cur = (big_t*) malloc(hdr + size);
+	    if (cur == 0)
+		  throw std::bad_alloc();
+	    cur->size = hdr + size;
+	    cur->prev = 0;
+	    cur->next = big_;
+	    if (big_) big_->prev = cur;
+	    big_ = cur;
+	    reserved_ += cur->size;
+	    return reinterpret_cast<char*>(cur) + hdr;
+      }
+
+      size = round_up(size, ALIGN);
+      free_cell_t*&list = free_[size/ALIGN];
+      if (list) {
+	    free_cell_t*res = list;
+	    list = res->next;
+	    return res;
+      }
+
+      return alloc_small_(size);
+}
+
+void Arena::free(void*ptr, size_t size, arena_stats_t&stats)
+{
+      if (ptr == 0)
+	    return;
+
+      stats.count -= 1;
+      stats.bytes -= size;
+
+      if (size == 0)
+	    size = 1;
+
+      if (size > SMALL_MAX) {
+	    size_t hdr = round_up(sizeof(big_t), ALIGN);
+	    big_t*cur = reinterpret_cast<big_t*>(static_cast<char*>(ptr) - hdr);
+	    if (cur->prev) cur->prev->next = cur->next;
+	    else big_ = cur->next;
+	    if (cur->next) cur->next->prev = cur->prev;
+	    reserved_ -= cur->size;
+	    ::free(cur);
+	    return;
+      }
+
+      size = round_up(size, ALIGN);
+      free_cell_t*cell = static_cast<free_cell_t*>(ptr);
+      cell->next = free_[size/ALIGN];
+      free_[size/ALIGN] = cell;
+}
+
+void Arena::release()
+{
+      while (blocks_) {
+	    block_t*blk = blocks_;
+	    blocks_ = blk->next;
+	    ::free(blk);
+      }
+
+      while (big_) {
+	    big_t*cur = big_;
+	    big_ = cur->next;
+	    ::free(cur);
+      }
+
+      memset(free_, 0, sizeof free_);
+      block_ptr_ = 0;
+      block_rem_ = 0;
+      reserved_ = 0;
+
+      for (arena_stats_t*cur = stats_list ; cur ; cur = cur->next) {
+	    if (cur->arena != this)
+		  continue;
+	    cur->count = 0;
+	    cur->bytes = 0;
+      }
+}
+
+void arena_report(ostream&out, const char*phase)
+{
+      out << "debug: memory after " << phase << ":" << endl;
+
+      size_t total = 0;
+      for (arena_stats_t*cur = stats_list ; cur ; cur = cur->next) {
+	    if (cur->total_count == 0)
+		  continue;
+	    out << "debug:   " << cur->name
+		<< " (" << (cur->arena? cur->arena->name() : "none") << "): "
+		<< cur->count << " objects, " << cur->bytes << " bytes"
+		<< " (peak " << cur->peak_bytes << " bytes, "
+		<< cur->total_count << " allocated)" << endl;
+	    total += cur->bytes;
+      }
+
+      out << "debug:   " << total << " bytes in use; arenas hold "
+	  << pform_arena.reserved() << " bytes (pform) and "
+	  << netlist_arena.reserved() << " bytes (netlist)" << endl;
+}
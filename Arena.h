@@ -0,0 +1,109 @@
+#ifndef __Arena_H
+#define __Arena_H
+/*
+ * Copyright (c) 2013 Stephen Williams (steve@icarus.com)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+# include  <cstddef>
+# include  <iostream>
+
+class Arena;
+
+/*
+ * Each class that allocates from an Arena has one of these to count
+ * its objects. The counts are reported by the "-d memory" debug flag.
+ */
+struct arena_stats_t {
+      explicit arena_stats_t(const char*n);
+
+      const char*name;
+	// Objects and bytes currently allocated.
+      size_t count;
+      size_t bytes;
+	// High water mark for bytes, and total number of objects
+	// ever allocated.
+      size_t peak_bytes;
+      size_t total_count;
+	// The arena this class allocates from, and the list of all
+	// the stats objects that have been used so far.
+      Arena*arena;
+      arena_stats_t*next;
+};
+
+/*
+ * An Arena allocates small objects out of large blocks. Freed objects
+ * are kept on a list for their size and reused, and the whole Arena
+ * can be released at once when none of its objects are needed any
+ * more. Objects that are too large for the size lists are allocated
+ * individually, but are still released with the Arena.
+ */
+class Arena {
+
+    public:
+      explicit Arena(const char*name);
+      ~Arena();
+
+      void* alloc(size_t size, arena_stats_t&stats);
+      void free(void*ptr, size_t size, arena_stats_t&stats);
+
+	// Free all the memory of the arena. All the objects that were
+	// allocated here are gone, and their destructors are not
+	// run, so use this only when nothing refers to them.
+      void release();
+
+      const char*name() const { return name_; }
+	// Bytes of memory the arena holds from the system.
+      size_t reserved() const { return reserved_; }
+
+    private:
+      enum { ALIGN = 8, SMALL_MAX = 512, BLOCK_SIZE = 0x10000 };
+
+      struct free_cell_t { free_cell_t*next; };
+      struct block_t { block_t*next; };
+      struct big_t { big_t*next; big_t*prev; size_t size; };
+
+      void* alloc_small_(size_t size);
+
+      const char*name_;
+      free_cell_t*free_[SMALL_MAX/ALIGN + 1];
+      block_t*blocks_;
+      char*block_ptr_;
+      size_t block_rem_;
+      big_t*big_;
+      size_t reserved_;
+
+    private: // not implemented
+      Arena(const Arena&);
+      Arena& operator= (const Arena&);
+};
+
+/*
+ * The pform arena holds the parse tree. It is released after
+ * elaboration, before the target code generator runs. The netlist
+ * arena holds the bulk of the netlist, which lives until the end.
+ */
+extern Arena pform_arena;
+extern Arena netlist_arena;
+
+/*
+ * Print the object counts of all the classes that allocate from
+ * arenas, and the sizes of the arenas themselves.
+ */
+extern void arena_report(std::ostream&out, const char*phase);
+
+#endif /* __Arena_H */
@@ -24,6 +24,7 @@
 
 # include  "compiler.h"
 # include  "PExpr.h"
+# include  "Arena.h"
 # include  "PWire.h"
 # include  "Module.h"
 # include  "netmisc.h"
@@ -42,6 +43,18 @@ PExpr::~PExpr()
 {
 }
 
+static arena_stats_t pexpr_stats ("PExpr");
+
+void* PExpr::operator new(size_t size)
+{
+      return pform_arena.alloc(size, pexpr_stats);
+}
+
+void PExpr::operator delete(void*ptr, size_t size)
+{
+      pform_arena.free(ptr, size, pexpr_stats);
+}
+
 void PExpr::declare_implicit_nets(LexicalScope*, NetNet::Type)
 {
 }
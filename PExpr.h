@@ -60,6 +60,10 @@ class PExpr : public LineInfo {
       PExpr();
       virtual ~PExpr();
 
+	// These objects are allocated from the pform arena.
+      void* operator new(size_t size);
+      void operator delete(void*ptr, size_t size);
+
       virtual void dump(ostream&) const;
 
         // This method tests whether the expression contains any identifiers
@@ -729,6 +733,11 @@ class PEBinary : public PExpr {
                                      unsigned flags) const;
       virtual verinum* eval_const(Design*des, NetScope*sc) const;
 
+    public:
+      inline char get_op() const { return op_; }
+      inline PExpr*get_left() const { return left_; }
+      inline PExpr*get_right() const { return right_; }
+
     protected:
       char op_;
       PExpr*left_;
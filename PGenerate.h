@@ -36,6 +36,7 @@ class PProcess;
 class PTask;
 class PGate;
 class PWire;
+struct genvar_loop_fast_t;
 
 /*
  * This represents a generate scheme. The interpretation of the
@@ -109,6 +110,9 @@ class PGenerate : public LineInfo, public LexicalScope {
 
     private:
       bool generate_scope_loop_(Design*des, NetScope*container);
+      bool generate_loop_test_(Design*des, NetScope*container,
+			       const genvar_loop_fast_t&fast,
+			       bool&result) const;
       bool generate_scope_condit_(Design*des, NetScope*container, bool else_flag);
       bool generate_scope_case_(Design*des, NetScope*container);
       bool generate_scope_nblock_(Design*des, NetScope*container);
@@ -20,6 +20,7 @@
 # include "config.h"
 # include  "PWire.h"
 # include  "PExpr.h"
+# include  "Arena.h"
 # include  <cassert>
 
 PWire::PWire(perm_string n,
@@ -39,6 +40,18 @@ PWire::PWire(perm_string n,
       }
 }
 
+static arena_stats_t pwire_stats ("PWire");
+
+void* PWire::operator new(size_t size)
+{
+      return pform_arena.alloc(size, pwire_stats);
+}
+
+void PWire::operator delete(void*ptr, size_t size)
+{
+      pform_arena.free(ptr, size, pwire_stats);
+}
+
 NetNet::Type PWire::get_wire_type() const
 {
       return type_;
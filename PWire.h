@@ -59,6 +59,10 @@ class PWire : public LineInfo {
 	    NetNet::PortType pt,
 	    ivl_variable_type_t dt);
 
+	// These objects are allocated from the pform arena.
+      void* operator new(size_t size);
+      void operator delete(void*ptr, size_t size);
+
 	// Return a hierarchical name.
       perm_string basename() const;
 
@@ -21,12 +21,25 @@
 
 # include  "Statement.h"
 # include  "PExpr.h"
+# include  "Arena.h"
 # include  "ivl_assert.h"
 
 Statement::~Statement()
 {
 }
 
+static arena_stats_t statement_stats ("Statement");
+
+void* Statement::operator new(size_t size)
+{
+      return pform_arena.alloc(size, statement_stats);
+}
+
+void Statement::operator delete(void*ptr, size_t size)
+{
+      pform_arena.free(ptr, size, statement_stats);
+}
+
 PAssign_::PAssign_(PExpr*lval__, PExpr*ex, bool is_constant)
 : event_(0), count_(0), lval_(lval__), rval_(ex), is_constant_(is_constant)
 {
@@ -81,6 +81,10 @@ class Statement : public LineInfo {
       Statement() { }
       virtual ~Statement() =0;
 
+	// These objects are allocated from the pform arena.
+      void* operator new(size_t size);
+      void operator delete(void*ptr, size_t size);
+
       virtual void dump(ostream&out, unsigned ind) const;
       virtual NetProc* elaborate(Design*des, NetScope*scope) const;
       virtual void elaborate_scope(Design*des, NetScope*scope) const;
@@ -104,6 +104,7 @@ extern bool debug_elaborate;
 extern bool debug_emit;
 extern bool debug_synth2;
 extern bool debug_optimizer;
+extern bool debug_memory;
 
 /* Control evaluation of functions at compile time:
  *   0 = only for functions in constant expressions
@@ -25,6 +25,7 @@
 # include  <iostream>
 # include  <cstdlib>
 # include  <cstdio>
+# include  <climits>
 
 /*
  * Elaboration happens in two passes, generally. The first scans the
@@ -850,6 +851,175 @@ bool PGenerate::generate_scope(Design*des, NetScope*container)
       }
 }
 
+/*
+ * Most generate loops have the simple form
+ *
+ *     for (i = <init> ; i <cmp> <bound> ; i = i +/- <incr>)
+ *
+ * where <bound> and <incr> are numbers or simple parameter names
+ * that do not depend on the genvar. For loops like that, the test
+ * and step expressions can be evaluated once and the iteration done
+ * with native integer arithmetic instead of elaborating and
+ * evaluating the expressions again for every iteration. Anything
+ * that does not match is handled by the general path.
+ */
+struct genvar_loop_fast_t {
+      genvar_loop_fast_t() : test_op(0), bound(0), bound_signed(false),
+			     step_op(0), incr(0), incr_signed(false) { }
+
+	// Comparison operator of the test, or 0 if the test must be
+	// evaluated by the general path.
+      char test_op;
+      long bound;
+      bool bound_signed;
+	// '+' or '-' for the step, or 0 if the step must be
+	// evaluated by the general path.
+      char step_op;
+      long incr;
+      bool incr_signed;
+
+      bool test(long genvar, bool&result) const;
+      bool step(long genvar, long&result) const;
+};
+
+static bool is_genvar_ident(const PExpr*expr, perm_string genvar)
+{
+      const PEIdent*id = dynamic_cast<const PEIdent*>(expr);
+      if (id == 0)
+	    return false;
+      if (id->path().size() != 1)
+	    return false;
+
+      const name_component_t&tail = id->path().back();
+      return tail.index.empty() && tail.name == genvar;
+}
+
+/*
+ * Evaluate the constant operand of a genvar test or step. Only
+ * numbers and simple (unindexed) identifiers other than the genvar
+ * itself are accepted, so that the value cannot change between
+ * iterations. The value is returned in val. If the operand has the
+ * right form but cannot be elaborated at all, then the caller gives
+ * up, as the general path would.
+ */
+static int genvar_loop_operand(Design*des, NetScope*scope, PExpr*expr,
+			       perm_string genvar, long&val, bool&signed_flag)
+{
+      if (dynamic_cast<PENumber*>(expr) == 0) {
+	    const PEIdent*id = dynamic_cast<const PEIdent*>(expr);
+	    if (id == 0 || id->path().size() != 1)
+		  return 0;
+	    if (! id->path().back().index.empty())
+		  return 0;
+	    if (id->path().back().name == genvar)
+		  return 0;
+      }
+
+      NetExpr*ex = elab_and_eval(des, scope, expr, -1, true);
+      if (ex == 0)
+	    return -1;
+
+	// Values that are not integer constants (a real parameter,
+	// for example) are left to the general path.
+      NetEConst*ce = dynamic_cast<NetEConst*>(ex);
+      if (ce == 0) {
+	    delete ex;
+	    return 0;
+      }
+
+      const verinum&tmp = ce->value();
+      if (! tmp.is_defined() || tmp.len() > 32) {
+	    delete ex;
+	    return 0;
+      }
+
+      val = tmp.as_long();
+      signed_flag = tmp.has_sign();
+      delete ex;
+      return 1;
+}
+
+bool genvar_loop_fast_t::test(long genvar, bool&result) const
+{
+      if (test_op == 0)
+	    return false;
+	// A negative genvar compared with an unsigned bound is an
+	// unsigned compare. Leave that to the general path.
+      if (!bound_signed && genvar < 0)
+	    return false;
+
+      switch (test_op) {
+	  case '<':
+	    result = genvar < bound;
+	    break;
+	  case '>':
+	    result = genvar > bound;
+	    break;
+	  case 'L':
+	    result = genvar <= bound;
+	    break;
+	  case 'G':
+	    result = genvar >= bound;
+	    break;
+	  case 'e':
+	    result = genvar == bound;
+	    break;
+	  case 'n':
+	    result = genvar != bound;
+	    break;
+	  default:
+	    return false;
+      }
+
+      return true;
+}
+
+bool genvar_loop_fast_t::step(long genvar, long&result) const
+{
+      if (step_op == 0)
+	    return false;
+
+      long tmp = step_op == '+'? genvar + incr : genvar - incr;
+
+	// The genvar is a 32bit integer. If the result would wrap,
+	// or if it goes negative in an unsigned expression, then let
+	// the general path work out the details.
+      if (tmp < INT_MIN || tmp > INT_MAX)
+	    return false;
+      if (!incr_signed && tmp < 0)
+	    return false;
+
+      result = tmp;
+      return true;
+}
+
+/*
+ * Evaluate the loop test for the current genvar value, using the
+ * fast path if possible. Return false if the test cannot be
+ * evaluated at all.
+ */
+bool PGenerate::generate_loop_test_(Design*des, NetScope*container,
+				    const genvar_loop_fast_t&fast,
+				    bool&result) const
+{
+      if (fast.test(container->genvar_tmp_val, result))
+	    return true;
+
+      NetExpr*test_ex = elab_and_eval(des, container, loop_test, -1, true);
+      NetEConst*test = dynamic_cast<NetEConst*>(test_ex);
+      if (test == 0) {
+	    cerr << get_fileline() << ": error: Cannot evaluate genvar"
+		 << " conditional expression: " << *loop_test << endl;
+	    des->errors += 1;
+	    delete test_ex;
+	    return false;
+      }
+
+      result = test->value().as_long() != 0;
+      delete test_ex;
+      return true;
+}
+
 /*
  * This is the elaborate scope method for a generate loop.
  */
@@ -936,17 +1106,56 @@ bool PGenerate::generate_scope_loop_(Design*des, NetScope*container)
 
       if (debug_scopes)
 	    cerr << get_fileline() << ": debug: genvar init = " << genvar << endl;
+
+	// See if the test and step are simple enough to be done
+	// without elaborating them for every iteration.
+      genvar_loop_fast_t fast;
+      if (const PEBComp*cmp = dynamic_cast<const PEBComp*>(loop_test)) {
+	    if (is_genvar_ident(cmp->get_left(), loop_index)) {
+		  int rc = genvar_loop_operand(des, container, cmp->get_right(),
+					       loop_index, fast.bound,
+					       fast.bound_signed);
+		  if (rc < 0) {
+			cerr << get_fileline() << ": error: Cannot evaluate genvar"
+			     << " conditional expression: " << *loop_test << endl;
+			des->errors += 1;
+			return false;
+		  }
+		  if (rc > 0)
+			fast.test_op = cmp->get_op();
+	    }
+      }
+      if (const PEBinary*add = dynamic_cast<const PEBinary*>(loop_step)) {
+	    if ((add->get_op() == '+' || add->get_op() == '-')
+		&& dynamic_cast<const PEBComp*>(add) == 0
+		&& is_genvar_ident(add->get_left(), loop_index)) {
+		  int rc = genvar_loop_operand(des, container, add->get_right(),
+					       loop_index, fast.incr,
+					       fast.incr_signed);
+		  if (rc < 0) {
+			cerr << get_fileline() << ": error: Cannot evaluate genvar"
+			     << " step expression: " << *loop_step << endl;
+			des->errors += 1;
+			return false;
+		  }
+		  if (rc > 0)
+			fast.step_op = add->get_op();
+	    }
+      }
+
+      if (debug_scopes && (fast.test_op || fast.step_op))
+	    cerr << get_fileline() << ": debug: genvar loop uses native"
+		 << (fast.test_op? " test" : "")
+		 << (fast.step_op? " step" : "") << endl;
+
       container->genvar_tmp = loop_index;
       container->genvar_tmp_val = genvar;
-      NetExpr*test_ex = elab_and_eval(des, container, loop_test, -1, true);
-      NetEConst*test = dynamic_cast<NetEConst*>(test_ex);
-      if (test == 0) {
-	    cerr << get_fileline() << ": error: Cannot evaluate genvar"
-		 << " conditional expression: " << *loop_test << endl;
-	    des->errors += 1;
+
+      bool test;
+      if (! generate_loop_test_(des, container, fast, test))
 	    return false;
-      }
-      while (test->value().as_long()) {
+
+      while (test) {
 
 	      // The actual name of the scope includes the genvar so
 	      // that each instance has a unique name in the
@@ -984,25 +1193,27 @@ bool PGenerate::generate_scope_loop_(Design*des, NetScope*container)
 	    elaborate_subscope_(des, scope);
 
 	      // Calculate the step for the loop variable.
-	    NetExpr*step_ex = elab_and_eval(des, container, loop_step, -1, true);
-	    NetEConst*step = dynamic_cast<NetEConst*>(step_ex);
-	    if (step == 0) {
-		  cerr << get_fileline() << ": error: Cannot evaluate genvar"
-		       << " step expression: " << *loop_step << endl;
-		  des->errors += 1;
-		  return false;
+	    long next;
+	    if (! fast.step(genvar, next)) {
+		  NetExpr*step_ex = elab_and_eval(des, container, loop_step, -1, true);
+		  NetEConst*step = dynamic_cast<NetEConst*>(step_ex);
+		  if (step == 0) {
+			cerr << get_fileline() << ": error: Cannot evaluate genvar"
+			     << " step expression: " << *loop_step << endl;
+			des->errors += 1;
+			return false;
+		  }
+		  next = step->value().as_long();
+		  delete step;
 	    }
 	    if (debug_scopes)
 		  cerr << get_fileline() << ": debug: genvar step from "
-		       << genvar << " to " << step->value().as_long() << endl;
+		       << genvar << " to " << next << endl;
 
-	    genvar = step->value().as_long();
+	    genvar = next;
 	    container->genvar_tmp_val = genvar;
-	    delete step;
-	    delete test_ex;
-	    test_ex = elab_and_eval(des, container, loop_test, -1);
-	    test = dynamic_cast<NetEConst*>(test_ex);
-	    assert(test);
+	    if (! generate_loop_test_(des, container, fast, test))
+		  return false;
       }
 
 	// Clear the genvar_tmp field in the scope to reflect that the
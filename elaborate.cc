@@ -46,6 +46,7 @@
 # include  "parse_api.h"
 # include  "compiler.h"
 # include  "ivl_assert.h"
+# include  "Arena.h"
 
 
 void PGate::elaborate(Design*, NetScope*) const
@@ -5758,6 +5759,9 @@ Design* elaborate(list<perm_string>roots)
 	// scope) and clean them out.
       des->residual_defparams();
 
+      if (debug_memory)
+	    arena_report(cerr, "elaborate scopes");
+
 	// Errors already? Probably missing root modules. Just give up
 	// now and return nothing.
       if (des->errors > 0)
@@ -5826,6 +5830,9 @@ Design* elaborate(list<perm_string>roots)
 	    }
       }
 
+      if (debug_memory)
+	    arena_report(cerr, "elaborate signals");
+
 	// Now that the structure and parameters are taken care of,
 	// run through the pform again and generate the full netlist.
 
@@ -5854,6 +5861,9 @@ Design* elaborate(list<perm_string>roots)
 	    des = 0;
       }
 
+      if (debug_memory)
+	    arena_report(cerr, "elaborate netlist");
+
       if (debug_elaborate) {
                cerr << "<toplevel>" << ": debug: "
                     << " finishing with "
@@ -0,0 +1,291 @@
+#ifndef __ivl_digits_H
+#define __ivl_digits_H
+/*
+ * Copyright (c) 2013 Stephen Williams (steve@icarus.com)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * These are the multiple precision kernels shared by the compiler
+ * (verinum) and the run time (vvp_vector2_t). They work on arrays of
+ * half word digits, least significant digit first, so that the
+ * product of two digits, and a two digit dividend, fit in an
+ * unsigned long.
+ */
+static const unsigned HALF_BITS = 4 * sizeof(unsigned long);
+static const unsigned long HALF_MASK = (1UL << HALF_BITS) - 1UL;
+
+static inline void split_digits(unsigned long*dig, const unsigned long*val,
+				unsigned words)
+{
+      for (unsigned idx = 0 ;  idx < words ;  idx += 1) {
+	    dig[2*idx+0] = val[idx] & HALF_MASK;
+	    dig[2*idx+1] = val[idx] >> HALF_BITS;
+      }
+}
+
+static inline void join_digits(unsigned long*val, const unsigned long*dig,
+			       unsigned words)
+{
+      for (unsigned idx = 0 ;  idx < words ;  idx += 1)
+	    val[idx] = dig[2*idx+0] | (dig[2*idx+1] << HALF_BITS);
+}
+
+/*
+ * The comba_digits function computes a product a column at a time
+ * (Comba's method) and keeps the column sums in a two word
+ * accumulator, so each digit of the result is written once. Operands
+ * of KARATSUBA_DIGITS or more are split in half, and Karatsuba's
+ * method does three half size products instead of four.
+ */
+static const unsigned KARATSUBA_DIGITS = 32;
+
+/*
+ * r[0..rn) = the low rn digits of a*b.
+ */
+static inline void comba_digits(unsigned long*r, unsigned rn,
+				const unsigned long*a, unsigned an,
+				const unsigned long*b, unsigned bn)
+{
+      if (an == 0 || bn == 0) {
+	    for (unsigned idx = 0 ;  idx < rn ;  idx += 1)
+		  r[idx] = 0;
+	    return;
+      }
+
+      unsigned long acc = 0, over = 0;
+      for (unsigned kdx = 0 ;  kdx < rn ;  kdx += 1) {
+	    unsigned lo = (kdx >= bn)? kdx-bn+1 : 0;
+	    unsigned hi = (kdx < an)? kdx : an-1;
+	    for (unsigned idx = lo ;  idx <= hi ;  idx += 1) {
+		  unsigned long prod = a[idx] * b[kdx-idx];
+		  acc += prod;
+		  if (acc < prod)
+			over += 1;
+	    }
+	    r[kdx] = acc & HALF_MASK;
+	    acc = (acc >> HALF_BITS) | (over << HALF_BITS);
+	    over >>= HALF_BITS;
+      }
+}
+
+/*
+ * x[0..xn) += y[0..yn), where any digits of y past xn are zero.
+ */
+static inline void add_digits(unsigned long*x, unsigned xn,
+			      const unsigned long*y, unsigned yn)
+{
+      unsigned long carry = 0;
+      unsigned idx = 0;
+      for ( ;  idx < xn && idx < yn ;  idx += 1) {
+	    unsigned long tmp = x[idx] + y[idx] + carry;
+	    x[idx] = tmp & HALF_MASK;
+	    carry = tmp >> HALF_BITS;
+      }
+      for ( ;  carry && idx < xn ;  idx += 1) {
+	    unsigned long tmp = x[idx] + carry;
+	    x[idx] = tmp & HALF_MASK;
+	    carry = tmp >> HALF_BITS;
+      }
+}
+
+/*
+ * x[0..xn) -= y[0..yn), where the result is known to be positive.
+ */
+static inline void sub_digits(unsigned long*x, unsigned xn,
+			      const unsigned long*y, unsigned yn)
+{
+      unsigned long borrow = 0;
+      unsigned idx = 0;
+      for ( ;  idx < yn ;  idx += 1) {
+	    unsigned long tmp = x[idx] - y[idx] - borrow;
+	    x[idx] = tmp & HALF_MASK;
+	    borrow = (tmp >> HALF_BITS) ? 1 : 0;
+      }
+      for ( ;  borrow && idx < xn ;  idx += 1) {
+	    unsigned long tmp = x[idx] - borrow;
+	    x[idx] = tmp & HALF_MASK;
+	    borrow = (tmp >> HALF_BITS) ? 1 : 0;
+      }
+}
+
+/*
+ * r[0..2n) = a*b, where a and b are n digits.
+ */
+static inline void karatsuba_digits(unsigned long*r, const unsigned long*a,
+				    const unsigned long*b, unsigned n)
+{
+      if (n < KARATSUBA_DIGITS) {
+	    comba_digits(r, 2*n, a, n, b, n);
+	    return;
+      }
+
+      const unsigned m = n/2;
+      const unsigned h = n - m;
+
+	// The low and high products go directly into the result.
+      karatsuba_digits(r, a, b, m);
+      karatsuba_digits(r+2*m, a+m, b+m, h);
+
+	// The middle term is (a0+a1)*(b0+b1) - a0*b0 - a1*b1.
+      unsigned long*sa = new unsigned long[4*(h+1)];
+      unsigned long*sb = sa + (h+1);
+      unsigned long*mid = sb + (h+1);
+      for (unsigned idx = 0 ;  idx <= h ;  idx += 1) {
+	    sa[idx] = (idx < h)? a[m+idx] : 0;
+	    sb[idx] = (idx < h)? b[m+idx] : 0;
+      }
+      add_digits(sa, h+1, a, m);
+      add_digits(sb, h+1, b, m);
+
+      karatsuba_digits(mid, sa, sb, h+1);
+      sub_digits(mid, 2*(h+1), r, 2*m);
+      sub_digits(mid, 2*(h+1), r+2*m, 2*h);
+      add_digits(r+m, 2*n-m, mid, 2*(h+1));
+
+      delete[]sa;
+}
+
+/*
+ * r[0..n) = the low n digits of a*b, where a and b are n digits. The
+ * high half of each operand only contributes to the cross terms, and
+ * only their low digits are needed.
+ */
+static inline void mul_low_digits(unsigned long*r, const unsigned long*a,
+				  const unsigned long*b, unsigned n)
+{
+      if (n < KARATSUBA_DIGITS) {
+	    comba_digits(r, n, a, n, b, n);
+	    return;
+      }
+
+      const unsigned h = n/2;
+      const unsigned m = n - h;
+
+      unsigned long*tmp = new unsigned long[2*m + h];
+      karatsuba_digits(tmp, a, b, m);
+      for (unsigned idx = 0 ;  idx < n ;  idx += 1)
+	    r[idx] = tmp[idx];
+
+      unsigned long*cross = tmp + 2*m;
+      mul_low_digits(cross, a, b+m, h);
+      add_digits(r+m, h, cross, h);
+      mul_low_digits(cross, a+m, b, h);
+      add_digits(r+m, h, cross, h);
+
+      delete[]tmp;
+}
+
+/*
+ * r[0..rn) = the low rn digits of a*b.
+ */
+static inline void mul_digits(unsigned long*r, unsigned rn,
+			      const unsigned long*a, unsigned an,
+			      const unsigned long*b, unsigned bn)
+{
+	// Leading zero digits add nothing to the product.
+      while (an > 0 && a[an-1] == 0)
+	    an -= 1;
+      while (bn > 0 && b[bn-1] == 0)
+	    bn -= 1;
+
+      unsigned n = (an > bn)? an : bn;
+      unsigned s = (an > bn)? bn : an;
+      if (s < KARATSUBA_DIGITS || 2*s < n) {
+	    comba_digits(r, rn, a, an, b, bn);
+	    return;
+      }
+
+	// Pad the operands to the same size for Karatsuba.
+      unsigned long*ap = new unsigned long[4*n];
+      unsigned long*bp = ap + n;
+      unsigned long*pp = bp + n;
+      for (unsigned idx = 0 ;  idx < n ;  idx += 1) {
+	    ap[idx] = (idx < an)? a[idx] : 0;
+	    bp[idx] = (idx < bn)? b[idx] : 0;
+      }
+
+      unsigned pn;
+      if (rn <= n) {
+	    mul_low_digits(pp, ap, bp, n);
+	    pn = n;
+      } else {
+	    karatsuba_digits(pp, ap, bp, n);
+	    pn = 2*n;
+      }
+
+      for (unsigned idx = 0 ;  idx < rn ;  idx += 1)
+	    r[idx] = (idx < pn)? pp[idx] : 0;
+
+      delete[]ap;
+}
+
+/*
+ * This is Knuth's Algorithm D (TAOCP Vol. 2, 4.3.1). The un array has
+ * m+1 digits and vn has n digits, both already normalized so that the
+ * top bit of vn[n-1] is set, and n >= 2. The m-n+1 quotient digits are
+ * written to q, and the (normalized) remainder is left in un[0..n-1].
+ */
+static inline void divide_digits(unsigned long*un, unsigned m,
+				 const unsigned long*vn, unsigned n, unsigned long*q)
+{
+      const unsigned long base = 1UL << HALF_BITS;
+
+      for (unsigned jdx = m-n+1 ;  jdx > 0 ;  jdx -= 1) {
+	    unsigned j = jdx - 1;
+
+	      // Estimate the quotient digit from the top digits and
+	      // correct it so that it is at most one too large.
+	    unsigned long num = (un[j+n] << HALF_BITS) | un[j+n-1];
+	    unsigned long qhat = num / vn[n-1];
+	    unsigned long rhat = num % vn[n-1];
+	    while (qhat >= base || qhat*vn[n-2] > ((rhat<<HALF_BITS) | un[j+n-2])) {
+		  qhat -= 1;
+		  rhat += vn[n-1];
+		  if (rhat >= base) break;
+	    }
+
+	      // Multiply and subtract.
+	    unsigned long carry = 0, borrow = 0;
+	    for (unsigned idx = 0 ;  idx < n ;  idx += 1) {
+		  unsigned long prod = qhat*vn[idx] + carry;
+		  carry = prod >> HALF_BITS;
+		  unsigned long tmp = un[idx+j] - (prod & HALF_MASK) - borrow;
+		  un[idx+j] = tmp & HALF_MASK;
+		  borrow = (tmp >> HALF_BITS) ? 1 : 0;
+	    }
+	    unsigned long tmp = un[j+n] - carry - borrow;
+	    un[j+n] = tmp & HALF_MASK;
+
+	      // If the result went negative, then the estimate was
+	      // still one too large, so add the divisor back.
+	    if (tmp >> HALF_BITS) {
+		  qhat -= 1;
+		  carry = 0;
+		  for (unsigned idx = 0 ;  idx < n ;  idx += 1) {
+			tmp = un[idx+j] + vn[idx] + carry;
+			un[idx+j] = tmp & HALF_MASK;
+			carry = tmp >> HALF_BITS;
+		  }
+		  un[j+n] = (un[j+n] + carry) & HALF_MASK;
+	    }
+
+	    q[j] = qhat;
+      }
+}
+
+#endif /* __ivl_digits_H */
@@ -2316,6 +2316,16 @@ extern DLLEXPORT const char* target_query(const char*key);
    This function is implemented in the loaded target, and not in the
    ivl core. This function is how the target module is invoked. */
 
+/* target_query
+
+   The "target_query" function is called by the ivl core to ask the
+   target about itself. The key "version" returns a version string
+   for the target. If the key "release_netlist" returns a non-nil
+   string, then the target promises that it uses only the ivl_target
+   API during target_design, and the core releases its own netlist
+   before calling target_design to reduce the peak memory use. All
+   the ivl_* objects remain valid. Return nil for unknown keys. */
+
 typedef int  (*target_design_f)(ivl_design_t des);
 typedef const char* (*target_query_f) (const char*key);
 
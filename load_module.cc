@@ -23,6 +23,7 @@
 # include  "compiler.h"
 # include  <iostream>
 # include  <map>
+# include  <set>
 # include  <cstdlib>
 # include  <cstring>
 # include  <string>
@@ -46,6 +47,16 @@ struct module_library {
 static struct module_library*library_list = 0;
 static struct module_library*library_last = 0;
 
+/*
+ * This is the set of library files that have already been parsed
+ * during this run. A library file is parsed at most once, no matter
+ * how many instances reference the key that selected it. This matters
+ * when the file does not actually define the module that its name
+ * suggests, in which case every unresolved instance would otherwise
+ * run the preprocessor and parser over the same file again.
+ */
+static set<string> library_files_loaded;
+
 const char dir_character = '/';
 extern char depfile_mode;
 extern FILE *depend_file;
@@ -73,6 +84,16 @@ bool load_module(const char*type)
 
 	    sprintf(path, "%s%c%s", lcur->dir, dir_character, (*cur).second);
 
+	      /* If this file was already parsed, then whatever it
+		 defines is already in the pform. Do not parse it
+		 again. */
+	    if (! library_files_loaded.insert(path).second) {
+		  if (verbose_flag)
+			cerr << "Library file " << path
+			     << " already loaded." << endl;
+		  return true;
+	    }
+
 	    if(depend_file) {
                   if (depfile_mode == 'p') {
 		        fprintf(depend_file, "M %s\n", path);
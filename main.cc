@@ -61,6 +61,7 @@ const char NOTICE[] =
 # include  "compiler.h"
 # include  "discipline.h"
 # include  "t-dll.h"
+# include  "Arena.h"
 
 #if defined(__MINGW32__) && !defined(HAVE_GETOPT_H)
 extern "C" int getopt(int argc, char*argv[], const char*fmt);
@@ -170,6 +171,7 @@ bool debug_elaborate = false;
 bool debug_emit = false;
 bool debug_synth2 = false;
 bool debug_optimizer = false;
+bool debug_memory = false;
 
 /*
  * Optimization control flags.
@@ -612,6 +614,9 @@ static void read_iconfig_file(const char*ipath)
 		  } else if (strcmp(cp,"optimizer") == 0) {
 			debug_optimizer = true;
 			cerr << "debug: Enable optimizer debug" << endl;
+		  } else if (strcmp(cp,"memory") == 0) {
+			debug_memory = true;
+			cerr << "debug: Enable memory debug" << endl;
 		  } else {
 		  }
 
@@ -999,6 +1004,9 @@ int main(int argc, char*argv[])
       pform_set_timescale(def_ts_units, def_ts_prec, 0, 0);
       int rc = pform_parse(argv[optind]);
 
+      if (debug_memory)
+	    arena_report(cerr, "parse");
+
       if (pf_path) {
 	    ofstream out (pf_path);
 	    out << "PFORM DUMP NATURES:" << endl;
@@ -1156,6 +1164,9 @@ int main(int argc, char*argv[])
       }
       des->join_islands();
 
+      if (debug_memory)
+	    arena_report(cerr, "functors");
+
       if (net_path) {
 	    if (verbose_flag)
 		  cerr<<" dumping netlist to " <<net_path<< "..." <<endl;
@@ -1179,6 +1190,13 @@ int main(int argc, char*argv[])
 	    }
       }
 
+	/* Nothing after this point looks at the pform, so release
+	   it all before the code generator needs memory of its own. */
+      pform_arena.release();
+
+      if (debug_memory)
+	    arena_report(cerr, "pform release");
+
       if (verbose_flag) {
 	    cout << "CODE GENERATION" << endl;
       }
@@ -1207,6 +1225,9 @@ int main(int argc, char*argv[])
 	    }
       }
 
+      if (debug_memory)
+	    arena_report(cerr, "code generation");
+
       if (verbose_flag) {
 	    cout << "STATISTICS" << endl;
 	    cout << "lex_string:"
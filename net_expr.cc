@@ -24,6 +24,7 @@
 # include  "netdarray.h"
 # include  "compiler.h"
 # include  "netmisc.h"
+# include  "Arena.h"
 # include  <iostream>
 # include  "ivl_assert.h"
 
@@ -41,6 +42,18 @@ NetExpr::~NetExpr()
 {
 }
 
+static arena_stats_t netexpr_stats ("NetExpr");
+
+void* NetExpr::operator new(size_t size)
+{
+      return netlist_arena.alloc(size, netexpr_stats);
+}
+
+void NetExpr::operator delete(void*ptr, size_t size)
+{
+      netlist_arena.free(ptr, size, netexpr_stats);
+}
+
 ivl_type_t NetExpr::net_type() const
 {
       return net_type_;
@@ -22,6 +22,7 @@
 # include  <iostream>
 
 # include  "netlist.h"
+# include  "Arena.h"
 # include  <sstream>
 # include  <cstring>
 # include  <string>
@@ -117,6 +118,18 @@ Link::~Link()
       }
 }
 
+static arena_stats_t link_stats ("Link[]");
+
+void* Link::operator new[](size_t size)
+{
+      return netlist_arena.alloc(size, link_stats);
+}
+
+void Link::operator delete[](void*ptr, size_t size)
+{
+      netlist_arena.free(ptr, size, link_stats);
+}
+
 Nexus* Link::find_nexus_() const
 {
       assert(next_);
@@ -267,6 +280,18 @@ Nexus::~Nexus()
       delete[] name_;
 }
 
+static arena_stats_t nexus_stats ("Nexus");
+
+void* Nexus::operator new(size_t size)
+{
+      return netlist_arena.alloc(size, nexus_stats);
+}
+
+void Nexus::operator delete(void*ptr, size_t size)
+{
+      netlist_arena.free(ptr, size, nexus_stats);
+}
+
 bool Nexus::assign_lval() const
 {
       for (const Link*cur = first_nlink() ; cur ; cur = cur->next_nlink()) {
@@ -27,6 +27,7 @@
 # include  "compiler.h"
 # include  "netlist.h"
 # include  "netmisc.h"
+# include  "Arena.h"
 # include  "netclass.h"
 # include  "netdarray.h"
 # include  "netenum.h"
@@ -265,6 +266,18 @@ NetNode::~NetNode()
 	    design_->del_node(this);
 }
 
+static arena_stats_t netnode_stats ("NetNode");
+
+void* NetNode::operator new(size_t size)
+{
+      return netlist_arena.alloc(size, netnode_stats);
+}
+
+void NetNode::operator delete(void*ptr, size_t size)
+{
+      netlist_arena.free(ptr, size, netnode_stats);
+}
+
 NetBranch::NetBranch(ivl_discipline_t dis)
 : NetPins(2), IslandBranch(dis)
 {
@@ -630,6 +643,18 @@ NetNet::NetNet(NetScope*s, perm_string n, Type t, netvector_t*ty)
       s->add_signal(this);
 }
 
+static arena_stats_t netnet_stats ("NetNet");
+
+void* NetNet::operator new(size_t size)
+{
+      return netlist_arena.alloc(size, netnet_stats);
+}
+
+void NetNet::operator delete(void*ptr, size_t size)
+{
+      netlist_arena.free(ptr, size, netnet_stats);
+}
+
 NetNet::~NetNet()
 {
       if (eref_count_ > 0) {
@@ -981,6 +1006,18 @@ NetProc::~NetProc()
 {
 }
 
+static arena_stats_t netproc_stats ("NetProc");
+
+void* NetProc::operator new(size_t size)
+{
+      return netlist_arena.alloc(size, netproc_stats);
+}
+
+void NetProc::operator delete(void*ptr, size_t size)
+{
+      netlist_arena.free(ptr, size, netproc_stats);
+}
+
 NetProcTop::NetProcTop(NetScope*s, ivl_process_type_t t, NetProc*st)
 : type_(t), statement_(st), scope_(s)
 {
@@ -104,6 +104,10 @@ class Link {
       Link();
       ~Link();
 
+	// The Link arrays are allocated from the netlist arena.
+      void* operator new[](size_t size);
+      void operator delete[](void*ptr, size_t size);
+
     public:
 	// Manipulate the link direction.
       void set_dir(DIR d);
@@ -341,6 +345,10 @@ class Nexus {
       explicit Nexus(Link&r);
       ~Nexus();
 
+	// These objects are allocated from the netlist arena.
+      void* operator new(size_t size);
+      void operator delete(void*ptr, size_t size);
+
     public:
 
       void connect(Link&r);
@@ -492,6 +500,10 @@ class NetNode  : public NetObj {
 
       virtual ~NetNode();
 
+	// These objects are allocated from the netlist arena.
+      void* operator new(size_t size);
+      void operator delete(void*ptr, size_t size);
+
       virtual bool emit_node(struct target_t*) const;
       virtual void dump_node(ostream&, unsigned) const;
 
@@ -640,6 +652,10 @@ class NetNet  : public NetObj, public PortType {
 
       virtual ~NetNet();
 
+	// These objects are allocated from the netlist arena.
+      void* operator new(size_t size);
+      void operator delete(void*ptr, size_t size);
+
       Type type() const;
       void type(Type t);
 
@@ -1859,6 +1875,10 @@ class NetExpr  : public LineInfo {
       explicit NetExpr(ivl_type_t t);
       virtual ~NetExpr() =0;
 
+	// These objects are allocated from the netlist arena.
+      void* operator new(size_t size);
+      void operator delete(void*ptr, size_t size);
+
       virtual void expr_scan(struct expr_scan_t*) const =0;
       virtual void dump(ostream&) const;
 
@@ -2454,6 +2474,10 @@ class NetProc : public virtual LineInfo {
       explicit NetProc();
       virtual ~NetProc();
 
+	// These objects are allocated from the netlist arena.
+      void* operator new(size_t size);
+      void operator delete(void*ptr, size_t size);
+
 	// Find the nexa that are input by the statement. This is used
 	// for example by @* to find the inputs to the process for the
 	// sensitivity list.
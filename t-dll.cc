@@ -32,6 +32,7 @@
 # include  <cstdlib>
 # include  "ivl_assert.h"
 # include  "ivl_alloc.h"
+# include  "Arena.h"
 
 struct dll_target dll_target_obj;
 
@@ -701,6 +702,15 @@ bool dll_target::start_design(const Design*des)
 	    return false;
       }
 
+	/* A target that only looks at the ivl_target API while it
+	   runs says so through the query hook. The netlist is then
+	   dropped before the target is called, so that the netlist
+	   and the target's own data are not in memory together. */
+      release_netlist_ = false;
+      target_query_f target_query = (target_query_f)ivl_dlsym(dll_, LU "target_query" TU);
+      if (target_query && (*target_query) ("release_netlist"))
+	    release_netlist_ = true;
+
       return true;
 }
 
@@ -712,6 +722,14 @@ int dll_target::end_design(const Design*)
 {
       int rc;
       if (errors == 0) {
+	    if (release_netlist_) {
+		  if (verbose_flag)
+			cout << " ... releasing the netlist" << endl;
+		  netlist_arena.release();
+		  if (debug_memory)
+			arena_report(cerr, "netlist release");
+	    }
+
 	    if (verbose_flag) {
 		  cout << " ... invoking target_design" << endl;
 	    }
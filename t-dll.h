@@ -103,6 +103,10 @@ struct dll_target  : public target_t, public expr_scan_t {
 
       target_design_f target_;
 
+	/* Set if the target does not need the netlist while it runs,
+	   so the netlist can be released once it is translated. */
+      bool release_netlist_;
+
 
 	/* These methods and members are used for forming the
 	   statements of a thread. */
@@ -30,61 +30,6 @@
 #define snprintf _snprintf
 #endif
 
-static ivl_signal_type_t signal_type_of_nexus(ivl_nexus_t nex)
-{
-      unsigned idx;
-      ivl_signal_type_t out = IVL_SIT_TRI;
-
-      for (idx = 0 ;  idx < ivl_nexus_ptrs(nex) ;  idx += 1) {
-	    ivl_signal_type_t stype;
-	    ivl_nexus_ptr_t ptr = ivl_nexus_ptr(nex, idx);
-	    ivl_signal_t sig = ivl_nexus_ptr_sig(ptr);
-	    if (sig == 0)
-		  continue;
-
-	    stype = ivl_signal_type(sig);
-	    if (stype == IVL_SIT_REG)
-		  continue;
-	    if (stype == IVL_SIT_TRI)
-		  continue;
-	    if (stype == IVL_SIT_NONE)
-		  continue;
-	    if (stype == IVL_SIT_UWIRE) return IVL_SIT_UWIRE;
-	    out = stype;
-      }
-
-      return out;
-}
-
-static ivl_variable_type_t signal_data_type_of_nexus(ivl_nexus_t nex)
-{
-      unsigned idx;
-      ivl_variable_type_t out = IVL_VT_NO_TYPE;
-
-      for (idx = 0 ;  idx < ivl_nexus_ptrs(nex) ;  idx += 1) {
-	    ivl_variable_type_t vtype;
-	    ivl_nexus_ptr_t ptr = ivl_nexus_ptr(nex, idx);
-	    ivl_signal_t sig = ivl_nexus_ptr_sig(ptr);
-	    if (sig == 0) continue;
-
-	    vtype = ivl_signal_data_type(sig);
-	    if (out == IVL_VT_NO_TYPE && vtype == IVL_VT_BOOL) {
-		  out = vtype;
-		  continue;
-	    }
-	    if (out != IVL_VT_LOGIC && vtype == IVL_VT_LOGIC) {
-		  out = vtype;
-		  continue;
-	    }
-	    if (vtype == IVL_VT_REAL) {
-		  out = vtype;
-		  break;
-	    }
-      }
-
-      return out;
-}
-
 static char* draw_C4_to_string(ivl_net_const_t cptr)
 {
       const char*bits = ivl_const_bits(cptr);
@@ -193,28 +138,6 @@ static int nexus_drive_is_strength_aware(ivl_nexus_ptr_t nptr)
       return 0;
 }
 
-/*
- * Given a nexus, look for a signal that has module delay
- * paths. Return that signal. (There should be no more than 1.) If we
- * don't find any, then return nil.
- */
-static ivl_signal_t find_modpath(ivl_nexus_t nex)
-{
-      unsigned idx;
-      for (idx = 0 ;  idx < ivl_nexus_ptrs(nex) ;  idx += 1) {
-	    ivl_nexus_ptr_t ptr = ivl_nexus_ptr(nex,idx);
-	    ivl_signal_t sig = ivl_nexus_ptr_sig(ptr);
-	    if (sig == 0)
-		  continue;
-	    if (ivl_signal_npath(sig) == 0)
-		  continue;
-
-	    return sig;
-      }
-
-      return 0;
-}
-
 static void str_repeat(char*buf, const char*str, unsigned rpt)
 {
       unsigned idx;
@@ -590,6 +513,67 @@ static void display_multi_driver_error(ivl_nexus_t nex, unsigned ndrivers,
  * draw_net_input for the general case.
  */
 
+/*
+ * This is a summary of the signals attached to a nexus. The
+ * draw_net_input_x function needs several facts about the signals of
+ * a nexus: the resolution type, the data type and which signal (if
+ * any) has module paths. These are all collected in the same pass
+ * over the nexus pointers that collects the drivers, instead of
+ * rescanning the pointer list for each fact.
+ */
+struct nexus_sig_summary {
+	/* The resolution type of the nexus. */
+      ivl_signal_type_t type;
+      int uwire_flag;
+	/* The data type of the nexus. */
+      ivl_variable_type_t data_type;
+	/* The signal that has module delay paths, or nil. (There
+	   should be no more than 1.) */
+      ivl_signal_t path_sig;
+};
+
+static void nexus_sig_summary_init(struct nexus_sig_summary*sum)
+{
+      sum->type = IVL_SIT_TRI;
+      sum->uwire_flag = 0;
+      sum->data_type = IVL_VT_NO_TYPE;
+      sum->path_sig = 0;
+}
+
+static void nexus_sig_summary_add(struct nexus_sig_summary*sum,
+				  ivl_signal_t sig)
+{
+      ivl_signal_type_t stype = ivl_signal_type(sig);
+      ivl_variable_type_t vtype = ivl_signal_data_type(sig);
+
+	/* Any uwire makes the nexus a uwire. Otherwise, the last
+	   signal with an explicit resolution type wins. */
+      switch (stype) {
+	  case IVL_SIT_REG:
+	  case IVL_SIT_TRI:
+	  case IVL_SIT_NONE:
+	    break;
+	  case IVL_SIT_UWIRE:
+	    sum->uwire_flag = 1;
+	    break;
+	  default:
+	    sum->type = stype;
+	    break;
+      }
+
+	/* Real takes precedence over logic, which takes precedence
+	   over bool. */
+      if (sum->data_type != IVL_VT_REAL) {
+	    if (sum->data_type == IVL_VT_NO_TYPE && vtype == IVL_VT_BOOL)
+		  sum->data_type = vtype;
+	    else if (vtype == IVL_VT_LOGIC || vtype == IVL_VT_REAL)
+		  sum->data_type = vtype;
+      }
+
+      if (sum->path_sig == 0 && ivl_signal_npath(sig) != 0)
+	    sum->path_sig = sig;
+}
+
 static ivl_nexus_ptr_t *drivers = 0x0;
 static unsigned adrivers = 0;
 
@@ -612,44 +596,23 @@ static void draw_net_input_x(ivl_nexus_t nex,
       unsigned ndrivers = 0;
 
       const char*resolv_type;
+      struct nexus_sig_summary sig_sum;
 
       char*nex_private = 0;
 
 	/* Accumulate nex_data flags. */
       int nex_flags = 0;
 
-      res = signal_type_of_nexus(nex);
-      switch (res) {
-	  case IVL_SIT_TRI:
-	  case IVL_SIT_UWIRE:
-	    resolv_type = "tri";
-	    break;
-	  case IVL_SIT_TRI0:
-	    resolv_type = "tri0";
-	    nex_flags |= VVP_NEXUS_DATA_STR;
-	    break;
-	  case IVL_SIT_TRI1:
-	    resolv_type = "tri1";
-	    nex_flags |= VVP_NEXUS_DATA_STR;
-	    break;
-	  case IVL_SIT_TRIAND:
-	    resolv_type = "triand";
-	    break;
-	  case IVL_SIT_TRIOR:
-	    resolv_type = "trior";
-	    break;
-	  default:
-	    fprintf(stderr, "vvp.tgt: Unsupported signal type: %d\n", res);
-	    assert(0);
-	    resolv_type = "tri";
-	    break;
-      }
-
+      nexus_sig_summary_init(&sig_sum);
 
       for (idx = 0 ;  idx < ivl_nexus_ptrs(nex) ;  idx += 1) {
 	    ivl_switch_t sw = 0;
+	    ivl_signal_t sig;
 	    ivl_nexus_ptr_t nptr = ivl_nexus_ptr(nex, idx);
 
+	    if ( (sig = ivl_nexus_ptr_sig(nptr)) )
+		  nexus_sig_summary_add(&sig_sum, sig);
+
 	      /* If this object is part of an island, then we'll be
 	         making a port. If this nexus is an output from any
 	         switches in the island, then set island_input_flag to
@@ -689,6 +652,33 @@ static void draw_net_input_x(ivl_nexus_t nex,
 	    ndrivers += 1;
       }
 
+      res = sig_sum.uwire_flag? IVL_SIT_UWIRE : sig_sum.type;
+      switch (res) {
+	  case IVL_SIT_TRI:
+	  case IVL_SIT_UWIRE:
+	    resolv_type = "tri";
+	    break;
+	  case IVL_SIT_TRI0:
+	    resolv_type = "tri0";
+	    nex_flags |= VVP_NEXUS_DATA_STR;
+	    break;
+	  case IVL_SIT_TRI1:
+	    resolv_type = "tri1";
+	    nex_flags |= VVP_NEXUS_DATA_STR;
+	    break;
+	  case IVL_SIT_TRIAND:
+	    resolv_type = "triand";
+	    break;
+	  case IVL_SIT_TRIOR:
+	    resolv_type = "trior";
+	    break;
+	  default:
+	    fprintf(stderr, "vvp.tgt: Unsupported signal type: %d\n", res);
+	    assert(0);
+	    resolv_type = "tri";
+	    break;
+      }
+
       if (island_input_flag < 0)
 	    island_input_flag = 0;
 
@@ -701,7 +691,7 @@ static void draw_net_input_x(ivl_nexus_t nex,
 	   0.0 into the net. */
       if (ndrivers == 0) {
 	      /* For real nets put 0.0. */
-	    if (signal_data_type_of_nexus(nex) == IVL_VT_REAL) {
+	    if (sig_sum.data_type == IVL_VT_REAL) {
 		  nex_private = draw_Cr_to_string(0.0);
 	    } else {
 		  unsigned jdx, wid = width_of_nexus(nex);
@@ -762,7 +752,7 @@ static void draw_net_input_x(ivl_nexus_t nex,
 	   it. Note that this will *not* work if the nexus is not a
 	   TRI type nexus. */
       if (ndrivers == 1 && res == IVL_SIT_TRI) {
-	    ivl_signal_t path_sig = find_modpath(nex);
+	    ivl_signal_t path_sig = sig_sum.path_sig;
 	    if (path_sig) {
 		  char*nex_str = draw_net_input_drive(nex, drivers[0]);
 		  char modpath_label[64];
@@ -785,7 +775,7 @@ static void draw_net_input_x(ivl_nexus_t nex,
       }
 
 	/* We currently only support one driver on real nets. */
-      if (ndrivers > 1 && signal_data_type_of_nexus(nex) == IVL_VT_REAL) {
+      if (ndrivers > 1 && sig_sum.data_type == IVL_VT_REAL) {
 	    display_multi_driver_error(nex, ndrivers, MDRV_REAL);
       }
 
@@ -0,0 +1,447 @@
+/*
+ * Copyright (c) 2013 Stephen Williams (steve@icarus.com)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+# include  "vvp_priv.h"
+# include  <string.h>
+# include  <ctype.h>
+# include  <stdlib.h>
+# include  <assert.h>
+# include  "ivl_alloc.h"
+
+/*
+ * The statement drawing code writes thread code straight to vvp_out
+ * one statement at a time, so it cannot see redundancies that span
+ * statements. To clean those up, the code for each thread is written
+ * to a scratch file instead, and when the thread is complete the
+ * lines are read back, passed through a peephole optimizer, and
+ * copied to the real output.
+ *
+ * The optimizer only looks at labels and the %jmp/%end instructions,
+ * so it is safe for any other instructions. It does these things:
+ *
+ *   - Jumps to a label whose first instruction is an unconditional
+ *     %jmp are retargeted to the final destination.
+ *
+ *   - Jumps to a label that immediately follows the jump are removed.
+ *
+ *   - Instructions after an unconditional %jmp or an %end, up to the
+ *     next label, can never execute and are removed.
+ */
+
+unsigned thread_opt_flag = 1;
+
+static FILE*real_out = 0;
+static FILE*scratch = 0;
+
+static char*text_buf = 0;
+static size_t text_size = 0;
+
+struct opt_line {
+      char*text;
+      size_t len;
+	/* Replacement text that this line owns, or nil. */
+      char*new_text;
+      int keep;
+};
+
+static struct opt_line*lines = 0;
+static unsigned lines_size = 0;
+static unsigned line_cnt = 0;
+
+static unsigned long stat_insns = 0;
+static unsigned long stat_removed = 0;
+static unsigned long stat_threaded = 0;
+
+/*
+ * The labels of the thread are kept in a small open hash table that
+ * maps the label name to its line number.
+ */
+static unsigned*label_tab = 0;
+static unsigned label_tab_size = 0;
+
+static unsigned hash_name(const char*name, size_t len)
+{
+      unsigned hash = 2166136261U;
+      size_t idx;
+      for (idx = 0 ; idx < len ; idx += 1) {
+	    hash ^= (unsigned char)name[idx];
+	    hash *= 16777619U;
+      }
+      return hash;
+}
+
+/*
+ * A code label starts in the first column, and is followed by either
+ * " ;" (possibly with a comment) or " %" and a labeled instruction.
+ * Return the length of the name, or 0 if this is not a label. If
+ * label_only is not nil, set it if there is no instruction.
+ */
+static size_t label_name_len(const struct opt_line*line, int*label_only)
+{
+      const char*cp = line->text;
+      size_t len = 0;
+
+      if (! (isalpha((unsigned char)cp[0]) || cp[0] == '_'))
+	    return 0;
+
+      while (len < line->len && cp[len] != ' ')
+	    len += 1;
+
+      if (len + 2 > line->len)
+	    return 0;
+      if (cp[len+1] != ';' && cp[len+1] != '%')
+	    return 0;
+
+      if (label_only)
+	    *label_only = cp[len+1] == ';';
+      return len;
+}
+
+static int is_insn(const struct opt_line*line)
+{
+      return strncmp(line->text, "    %", 5) == 0;
+}
+
+static int is_comment(const struct opt_line*line)
+{
+      return line->text[0] == ';';
+}
+
+static const char*line_text(const struct opt_line*line)
+{
+      return line->new_text ? line->new_text : line->text;
+}
+
+/*
+ * If the text is a jump, point *target at the target label and
+ * return the offset of the label in the text. An unconditional %jmp
+ * sets *uncond. Return 0 if this is not a jump.
+ */
+static size_t jump_parse(const char*text, const char**target,
+			 size_t*target_len, int*uncond)
+{
+      const char*cp;
+
+      if (strncmp(text, "    %jmp", 8) != 0)
+	    return 0;
+
+      cp = text + 8;
+      if (*cp == ' ') {
+	    *uncond = 1;
+      } else if (strncmp(cp, "/0 ", 3) == 0 || strncmp(cp, "/1 ", 3) == 0) {
+	    *uncond = 0;
+	    cp += 2;
+      } else if (strncmp(cp, "/0xz ", 5) == 0) {
+	    *uncond = 0;
+	    cp += 4;
+      } else {
+	    return 0;
+      }
+
+      while (*cp == ' ')
+	    cp += 1;
+
+      *target = cp;
+      *target_len = strcspn(cp, ",; ");
+      return cp - text;
+}
+
+static void label_tab_build(void)
+{
+      unsigned idx;
+
+      if (label_tab_size < 2*line_cnt) {
+	    label_tab_size = 64;
+	    while (label_tab_size < 2*line_cnt)
+		  label_tab_size *= 2;
+	    free(label_tab);
+	    label_tab = malloc(label_tab_size * sizeof(unsigned));
+      }
+
+      for (idx = 0 ; idx < label_tab_size ; idx += 1)
+	    label_tab[idx] = line_cnt;
+
+      for (idx = 0 ; idx < line_cnt ; idx += 1) {
+	    size_t len = label_name_len(lines+idx, 0);
+	    unsigned slot;
+	    if (len == 0)
+		  continue;
+
+	    slot = hash_name(lines[idx].text, len) & (label_tab_size-1);
+	    while (label_tab[slot] != line_cnt)
+		  slot = (slot + 1) & (label_tab_size-1);
+	    label_tab[slot] = idx;
+      }
+}
+
+static unsigned label_find(const char*name, size_t len)
+{
+      unsigned slot = hash_name(name, len) & (label_tab_size-1);
+
+      while (label_tab[slot] != line_cnt) {
+	    struct opt_line*cur = lines + label_tab[slot];
+	    if (label_name_len(cur, 0) == len
+		&& strncmp(cur->text, name, len) == 0)
+		  return label_tab[slot];
+	    slot = (slot + 1) & (label_tab_size-1);
+      }
+
+      return line_cnt;
+}
+
+/*
+ * Return the index of the first instruction at the label at line idx,
+ * skipping other labels and comments. Return line_cnt if there is
+ * something else (or nothing) there, or if the instruction shares a
+ * line with a label.
+ */
+static unsigned first_insn(unsigned idx)
+{
+      int label_only = 0;
+      label_name_len(lines+idx, &label_only);
+      if (! label_only)
+	    return line_cnt;
+
+      for (idx += 1 ; idx < line_cnt ; idx += 1) {
+	    label_only = 0;
+	    if (label_name_len(lines+idx, &label_only) == 0) {
+		  if (! is_comment(lines+idx))
+			break;
+	    } else if (! label_only) {
+		  return line_cnt;
+	    }
+      }
+
+      if (idx < line_cnt && is_insn(lines+idx))
+	    return idx;
+
+      return line_cnt;
+}
+
+static void thread_jumps(void)
+{
+      unsigned idx;
+
+      for (idx = 0 ; idx < line_cnt ; idx += 1) {
+	    const char*target;
+	    size_t target_len;
+	    int uncond;
+	    unsigned hops;
+	    size_t offset = jump_parse(lines[idx].text, &target,
+				       &target_len, &uncond);
+	    const char*use_target = target;
+	    size_t use_len = target_len;
+
+	    if (offset == 0)
+		  continue;
+
+	    for (hops = 0 ; hops < 64 ; hops += 1) {
+		  const char*next;
+		  size_t next_len;
+		  int next_uncond;
+		  unsigned lab = label_find(use_target, use_len);
+		  unsigned ins;
+		  if (lab == line_cnt)
+			break;
+		  ins = first_insn(lab);
+		  if (ins == line_cnt || ins == idx)
+			break;
+		  if (jump_parse(lines[ins].text, &next, &next_len,
+				 &next_uncond) == 0)
+			break;
+		  if (! next_uncond)
+			break;
+		  use_target = next;
+		  use_len = next_len;
+	    }
+
+	    if (use_target != target) {
+		  const char*tail = target + target_len;
+		  size_t tail_len = lines[idx].len - (tail - lines[idx].text);
+		  char*buf = malloc(offset + use_len + tail_len + 1);
+		  memcpy(buf, lines[idx].text, offset);
+		  memcpy(buf + offset, use_target, use_len);
+		  memcpy(buf + offset + use_len, tail, tail_len);
+		  buf[offset + use_len + tail_len] = 0;
+		  lines[idx].new_text = buf;
+		  stat_threaded += 1;
+	    }
+      }
+}
+
+static int remove_dead_code(void)
+{
+      unsigned idx;
+      int changed = 0;
+
+      for (idx = 0 ; idx < line_cnt ; idx += 1) {
+	    const char*target;
+	    size_t target_len;
+	    int uncond = 0;
+	    unsigned next;
+
+	    if (! lines[idx].keep || ! is_insn(lines+idx))
+		  continue;
+
+	    if (jump_parse(line_text(lines+idx), &target, &target_len, &uncond)) {
+		    /* A jump to the label that follows it does nothing,
+		       whether or not it is conditional. */
+		  for (next = idx+1 ; next < line_cnt ; next += 1) {
+			int label_only = 0;
+			size_t len = label_name_len(lines+next, &label_only);
+			if (len == 0) {
+			      if (! lines[next].keep || is_comment(lines+next))
+				    continue;
+			      break;
+			}
+			if (len == target_len
+			    && strncmp(lines[next].text, target, len) == 0) {
+			      lines[idx].keep = 0;
+			      stat_removed += 1;
+			      changed = 1;
+			      break;
+			}
+			if (! label_only)
+			      break;
+		  }
+		  if (! uncond)
+			continue;
+
+	    } else if (strcmp(lines[idx].text, "    %end;") != 0) {
+		  continue;
+	    }
+
+	      /* Nothing after this can run until the next label. */
+	    for (next = idx+1 ; next < line_cnt ; next += 1) {
+		  if (is_comment(lines+next))
+			continue;
+		  if (! is_insn(lines+next))
+			break;
+		  if (lines[next].keep) {
+			lines[next].keep = 0;
+			stat_removed += 1;
+			changed = 1;
+		  }
+	    }
+      }
+
+      return changed;
+}
+
+void thread_opt_begin(void)
+{
+      if (! thread_opt_flag || real_out)
+	    return;
+
+      if (scratch == 0) {
+	    scratch = tmpfile();
+	    if (scratch == 0) {
+		  thread_opt_flag = 0;
+		  return;
+	    }
+      }
+
+      rewind(scratch);
+      real_out = vvp_out;
+      vvp_out = scratch;
+}
+
+void thread_opt_end(void)
+{
+      long size;
+      size_t got;
+      unsigned idx;
+      char*cp;
+
+      if (real_out == 0)
+	    return;
+
+      vvp_out = real_out;
+      real_out = 0;
+
+      fflush(scratch);
+      size = ftell(scratch);
+      assert(size >= 0);
+      rewind(scratch);
+
+      if (text_size < (size_t)size + 1) {
+	    text_size = size + 1;
+	    text_buf = realloc(text_buf, text_size);
+      }
+      got = fread(text_buf, 1, size, scratch);
+      assert(got == (size_t)size);
+      text_buf[got] = 0;
+
+	/* Split the text into lines, without the newlines. */
+      line_cnt = 0;
+      for (cp = text_buf ; *cp ; ) {
+	    char*eol = strchr(cp, '\n');
+	    if (line_cnt == lines_size) {
+		  lines_size = lines_size ? 2*lines_size : 1024;
+		  lines = realloc(lines, lines_size * sizeof(struct opt_line));
+	    }
+	    if (eol) *eol = 0;
+	    lines[line_cnt].text = cp;
+	    lines[line_cnt].len = eol ? (size_t)(eol - cp) : strlen(cp);
+	    lines[line_cnt].new_text = 0;
+	    lines[line_cnt].keep = 1;
+	    if (is_insn(lines+line_cnt))
+		  stat_insns += 1;
+	    line_cnt += 1;
+	    cp = eol ? eol + 1 : cp + strlen(cp);
+      }
+
+      label_tab_build();
+      thread_jumps();
+	/* Removing code can put other jumps next to their targets,
+	   so repeat until nothing changes. */
+      while (remove_dead_code())
+	    ;
+
+      for (idx = 0 ; idx < line_cnt ; idx += 1) {
+	    if (lines[idx].keep)
+		  fprintf(vvp_out, "%s\n", line_text(lines+idx));
+	    free(lines[idx].new_text);
+      }
+}
+
+void thread_opt_report(void)
+{
+      if (! thread_opt_flag)
+	    return;
+
+      fprintf(vvp_out, "# Thread code optimizer: %lu of %lu instructions "
+	      "removed, %lu jumps threaded.\n",
+	      stat_removed, stat_insns, stat_threaded);
+}
+
+void thread_opt_cleanup(void)
+{
+      if (scratch) fclose(scratch);
+      scratch = 0;
+      free(text_buf);
+      text_buf = 0;
+      text_size = 0;
+      free(lines);
+      lines = 0;
+      lines_size = 0;
+      free(label_tab);
+      label_tab = 0;
+      label_tab_size = 0;
+}
@@ -48,6 +48,10 @@ FILE*vvp_out = 0;
 int vvp_errors = 0;
 unsigned show_file_line = 0;
 
+/* Size and storage of the output buffer for vvp_out. */
+#define VVP_OUT_BUFSIZE (1024*1024)
+static char*vvp_out_buf = 0;
+
 __inline__ static void draw_execute_header(ivl_design_t des)
 {
       const char*cp = ivl_design_flag(des, "VVP_EXECUTABLE");
@@ -99,6 +103,8 @@ int target_design(ivl_design_t des)
 	 * printed for procedural statements. (e.g. -pfileline=1).
 	 * The default is no file/line information will be included. */
       const char*fileline = ivl_design_flag(des, "fileline");
+	/* Use -popt=0 to turn off the thread code peephole optimizer. */
+      const char*opt = ivl_design_flag(des, "opt");
 
       assert(path);
 
@@ -128,6 +134,9 @@ int target_design(ivl_design_t des)
             show_file_line = fl_value > 0;
       }
 
+      if (strcmp(opt, "") != 0)
+	    thread_opt_flag = strtol(opt, 0, 0) != 0;
+
 #ifdef HAVE_FOPEN64
       vvp_out = fopen64(path, "w");
 #else
@@ -138,6 +147,17 @@ int target_design(ivl_design_t des)
 	    return -1;
       }
 
+	/* The output is written through a great many small fprintf
+	   calls. Give the stream a large buffer so that the actual
+	   writes to the file are done in big blocks. If the buffer
+	   cannot be allocated, the default stdio buffer is used. */
+      vvp_out_buf = malloc(VVP_OUT_BUFSIZE);
+      if (vvp_out_buf && setvbuf(vvp_out, vvp_out_buf, _IOFBF,
+				 VVP_OUT_BUFSIZE) != 0) {
+	    free(vvp_out_buf);
+	    vvp_out_buf = 0;
+      }
+
       vvp_errors = 0;
 
       draw_execute_header(des);
@@ -166,6 +186,9 @@ int target_design(ivl_design_t des)
 
       rc = ivl_design_process(des, draw_process, 0);
 
+      thread_opt_report();
+      thread_opt_cleanup();
+
         /* Dump the file name table. */
       size = ivl_file_table_size();
       fprintf(vvp_out, "# The file index is used to find the file name in "
@@ -175,6 +198,8 @@ int target_design(ivl_design_t des)
       }
 
       fclose(vvp_out);
+      free(vvp_out_buf);
+      vvp_out_buf = 0;
       EOC_cleanup_drivers();
 
       return rc + vvp_errors;
@@ -186,5 +211,10 @@ const char* target_query(const char*key)
       if (strcmp(key,"version") == 0)
 	    return version_string;
 
+	/* This target only uses the ivl_target API, so the compiler
+	   may release its netlist before calling target_design. */
+      if (strcmp(key,"release_netlist") == 0)
+	    return "true";
+
       return 0;
 }
@@ -47,6 +47,17 @@ extern unsigned transient_id;
  */
 extern unsigned show_file_line;
 
+/*
+ * The thread code for each process, task and function is passed
+ * through a peephole optimizer (opt_thread.c) between the begin and
+ * end calls. It is disabled with -popt=0.
+ */
+extern unsigned thread_opt_flag;
+extern void thread_opt_begin(void);
+extern void thread_opt_end(void);
+extern void thread_opt_report(void);
+extern void thread_opt_cleanup(void);
+
 struct vector_info {
       unsigned base;
       unsigned wid;
@@ -2356,6 +2356,7 @@ int draw_process(ivl_process_t net, void*x)
       }
 
       local_count = 0;
+      thread_opt_begin();
       fprintf(vvp_out, "    .scope S_%p;\n", scope);
 
 	/* Generate the entry label. Just give the thread a number so
@@ -2399,6 +2400,7 @@ int draw_process(ivl_process_t net, void*x)
 	    fprintf(vvp_out, "    .thread T_%u, $final;\n", thread_count);
 	    break;
       }
+      thread_opt_end();
 
       thread_count += 1;
       return rc;
@@ -2409,6 +2411,7 @@ int draw_task_definition(ivl_scope_t scope)
       int rc = 0;
       ivl_statement_t def = ivl_scope_def(scope);
 
+      thread_opt_begin();
       fprintf(vvp_out, "TD_%s ;\n", vvp_mangle_id(ivl_scope_name(scope)));
       clear_expression_lookaside();
 
@@ -2416,6 +2419,7 @@ int draw_task_definition(ivl_scope_t scope)
       rc += show_statement(def, scope);
 
       fprintf(vvp_out, "    %%end;\n");
+      thread_opt_end();
 
       thread_count += 1;
       return rc;
@@ -2426,6 +2430,7 @@ int draw_func_definition(ivl_scope_t scope)
       int rc = 0;
       ivl_statement_t def = ivl_scope_def(scope);
 
+      thread_opt_begin();
       fprintf(vvp_out, "TD_%s ;\n", vvp_mangle_id(ivl_scope_name(scope)));
       clear_expression_lookaside();
 
@@ -2433,6 +2438,7 @@ int draw_func_definition(ivl_scope_t scope)
       rc += show_statement(def, scope);
 
       fprintf(vvp_out, "    %%end;\n");
+      thread_opt_end();
 
       thread_count += 1;
       return rc;
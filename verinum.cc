@@ -20,6 +20,7 @@
 # include "config.h"
 
 # include  "verinum.h"
+# include  "ivl_digits.h"
 # include  <iostream>
 # include  <cassert>
 # include  <cmath> // Needed to get pow for as_double().
@@ -42,18 +43,204 @@ extern "C" long int lround(double x)
 
 static verinum::V add_with_carry(verinum::V l, verinum::V r, verinum::V&c);
 
+static inline unsigned count_words(unsigned nbits, unsigned bits_per_word)
+{
+      return (nbits + bits_per_word - 1) / bits_per_word;
+}
+
+/*
+ * Allocate (cleared) storage for nbits bits. Both arrays share one
+ * allocation, with the abits_ first.
+ */
+void verinum::allocate_(unsigned nbits)
+{
+      nbits_ = nbits;
+      unsigned words = count_words(nbits_, BITS_PER_WORD);
+      abits_ = new unsigned long[2*words];
+      bbits_ = abits_ + words;
+      for (unsigned idx = 0 ;  idx < 2*words ;  idx += 1)
+	    abits_[idx] = 0;
+}
+
+void verinum::fill_(V val)
+{
+      unsigned words = count_words(nbits_, BITS_PER_WORD);
+      unsigned long afill = (val == V1 || val == Vx)? -1UL : 0;
+      unsigned long bfill = (val == Vx || val == Vz)? -1UL : 0;
+      for (unsigned idx = 0 ;  idx < words ;  idx += 1) {
+	    abits_[idx] = afill;
+	    bbits_[idx] = bfill;
+      }
+
+      if (nbits_ % BITS_PER_WORD) {
+	    unsigned long mask = (1UL << (nbits_ % BITS_PER_WORD)) - 1UL;
+	    abits_[words-1] &= mask;
+	    bbits_[words-1] &= mask;
+      }
+}
+
+void verinum::to_words_(unsigned long*val, unsigned wid, bool sext) const
+{
+      unsigned words = count_words(wid, BITS_PER_WORD);
+      unsigned have = count_words(nbits_, BITS_PER_WORD);
+
+      unsigned long fill = 0;
+      if (sext && nbits_ > 0 && get(nbits_-1) == V1)
+	    fill = -1UL;
+
+      for (unsigned idx = 0 ;  idx < words ;  idx += 1)
+	    val[idx] = idx < have? abits_[idx] : fill;
+
+	/* Sign extend within the top word of the source. */
+      if (fill && nbits_ < wid && (nbits_ % BITS_PER_WORD))
+	    val[have-1] |= -1UL << (nbits_ % BITS_PER_WORD);
+
+      if (wid % BITS_PER_WORD)
+	    val[words-1] &= (1UL << (wid % BITS_PER_WORD)) - 1UL;
+}
+
+void verinum::from_words_(const unsigned long*val)
+{
+      unsigned words = count_words(nbits_, BITS_PER_WORD);
+      for (unsigned idx = 0 ;  idx < words ;  idx += 1) {
+	    abits_[idx] = val[idx];
+	    bbits_[idx] = 0;
+      }
+
+      if (nbits_ % BITS_PER_WORD)
+	    abits_[words-1] &= (1UL << (nbits_ % BITS_PER_WORD)) - 1UL;
+}
+
+/*
+ * The arithmetic below works on whole words when the operands are
+ * fully defined. Multiplication and division split the words into
+ * half-word digits (see ivl_digits.h) so that the partial products
+ * fit in a word.
+ */
+
+/*
+ * res = l + r + carry, all words wide.
+ */
+static void add_words(unsigned long*res, const unsigned long*l,
+		      const unsigned long*r, unsigned long carry,
+		      unsigned words)
+{
+      for (unsigned idx = 0 ;  idx < words ;  idx += 1) {
+	    unsigned long sum = l[idx] + carry;
+	    carry = (sum < carry)? 1 : 0;
+	    sum += r[idx];
+	    if (sum < r[idx]) carry = 1;
+	    res[idx] = sum;
+      }
+}
+
+/*
+ * res = l * r, truncated to words wide.
+ */
+static void mul_words(unsigned long*res, const unsigned long*l,
+		      const unsigned long*r, unsigned words)
+{
+      const unsigned digs = 2*words;
+      unsigned long*ld = new unsigned long[3*digs];
+      unsigned long*rd = ld + digs;
+      unsigned long*pd = rd + digs;
+      split_digits(ld, l, words);
+      split_digits(rd, r, words);
+
+      mul_digits(pd, digs, ld, digs, rd, digs);
+
+      join_digits(res, pd, words);
+      delete[]ld;
+}
+
+/*
+ * Unsigned division of words wide values. The divisor must not be
+ * zero. Either of quot or rem may be nil if the caller does not need
+ * that result.
+ */
+static void divide_words(const unsigned long*num, const unsigned long*den,
+			 unsigned words, unsigned long*quot, unsigned long*rem)
+{
+      const unsigned digs = 2*words;
+      unsigned long*un = new unsigned long[4*digs+1];
+      unsigned long*vn = un + digs+1;
+      unsigned long*qn = vn + digs;
+      unsigned long*rn = qn + digs;
+
+      split_digits(un, num, words);
+      split_digits(vn, den, words);
+      for (unsigned idx = 0 ;  idx < digs ;  idx += 1) {
+	    qn[idx] = 0;
+	    rn[idx] = 0;
+      }
+
+      unsigned m = digs;
+      while (m > 0 && un[m-1] == 0)
+	    m -= 1;
+      unsigned n = digs;
+      while (n > 0 && vn[n-1] == 0)
+	    n -= 1;
+      assert(n > 0);
+
+      if (n > m) {
+	    for (unsigned idx = 0 ;  idx < m ;  idx += 1)
+		  rn[idx] = un[idx];
+
+      } else if (n == 1) {
+	    unsigned long r = 0;
+	    for (unsigned idx = m ;  idx > 0 ;  idx -= 1) {
+		  unsigned long cur = (r << HALF_BITS) | un[idx-1];
+		  qn[idx-1] = cur / vn[0];
+		  r = cur % vn[0];
+	    }
+	    rn[0] = r;
+
+      } else {
+	      // Normalize so that the top digit of the divisor has
+	      // its high bit set.
+	    unsigned norm = 0;
+	    while ((vn[n-1] << norm) < (1UL << (HALF_BITS-1)))
+		  norm += 1;
+
+	    un[m] = 0;
+	    if (norm > 0) {
+		  for (unsigned idx = n ;  idx > 0 ;  idx -= 1) {
+			vn[idx-1] = (vn[idx-1] << norm) & HALF_MASK;
+			if (idx > 1)
+			      vn[idx-1] |= vn[idx-2] >> (HALF_BITS-norm);
+		  }
+		  for (unsigned idx = m+1 ;  idx > 0 ;  idx -= 1) {
+			un[idx-1] = (un[idx-1] << norm) & HALF_MASK;
+			if (idx > 1)
+			      un[idx-1] |= un[idx-2] >> (HALF_BITS-norm);
+		  }
+	    }
+
+	    divide_digits(un, m, vn, n, qn);
+
+	    for (unsigned idx = 0 ;  idx < n ;  idx += 1) {
+		  rn[idx] = un[idx] >> norm;
+		  if (norm > 0 && idx+1 < n)
+			rn[idx] |= (un[idx+1] << (HALF_BITS-norm)) & HALF_MASK;
+	    }
+      }
+
+      if (quot) join_digits(quot, qn, words);
+      if (rem)  join_digits(rem, rn, words);
+      delete[]un;
+}
+
 verinum::verinum()
-: bits_(0), nbits_(0), has_len_(false), has_sign_(false), is_single_(false), string_flag_(false)
+: abits_(0), bbits_(0), nbits_(0), has_len_(false), has_sign_(false), is_single_(false), string_flag_(false)
 {
 }
 
 verinum::verinum(const V*bits, unsigned nbits, bool has_len__)
 : has_len_(has_len__), has_sign_(false), is_single_(false), string_flag_(false)
 {
-      nbits_ = nbits;
-      bits_ = new V [nbits];
+      allocate_(nbits);
       for (unsigned idx = 0 ;  idx < nbits ;  idx += 1) {
-	    bits_[idx] = bits[idx];
+	    set(idx, bits[idx]);
       }
 }
 
@@ -114,57 +301,43 @@ verinum::verinum(const string&s)
 : has_len_(true), has_sign_(false), is_single_(false), string_flag_(true)
 {
       string str = process_verilog_string_quotes(s);
-      nbits_ = str.length() * 8;
 
 	// Special case: The string "" is 8 bits of 0.
-      if (nbits_ == 0) {
-	    nbits_ = 8;
-	    bits_ = new V [nbits_];
-	    bits_[0] = V0;
-	    bits_[1] = V0;
-	    bits_[2] = V0;
-	    bits_[3] = V0;
-	    bits_[4] = V0;
-	    bits_[5] = V0;
-	    bits_[6] = V0;
-	    bits_[7] = V0;
+      if (str.length() == 0) {
+	    allocate_(8);
 	    return;
       }
 
-      bits_ = new V [nbits_];
+      allocate_(str.length() * 8);
 
+	// The first character is the most significant byte. The
+	// words are a whole number of bytes, so a character never
+	// straddles two words.
       unsigned idx, cp;
-      V*bp = bits_+nbits_;
       for (idx = nbits_, cp = 0 ;  idx > 0 ;  idx -= 8, cp += 1) {
-	    char ch = str[cp];
-	    *(--bp) = (ch&0x80) ? V1 : V0;
-	    *(--bp) = (ch&0x40) ? V1 : V0;
-	    *(--bp) = (ch&0x20) ? V1 : V0;
-	    *(--bp) = (ch&0x10) ? V1 : V0;
-	    *(--bp) = (ch&0x08) ? V1 : V0;
-	    *(--bp) = (ch&0x04) ? V1 : V0;
-	    *(--bp) = (ch&0x02) ? V1 : V0;
-	    *(--bp) = (ch&0x01) ? V1 : V0;
+	    unsigned char ch = str[cp];
+	    unsigned off = idx - 8;
+	    abits_[off/BITS_PER_WORD] |= (unsigned long)ch << (off%BITS_PER_WORD);
       }
 }
 
 verinum::verinum(verinum::V val, unsigned n, bool h)
 : has_len_(h), has_sign_(false), is_single_(false), string_flag_(false)
 {
-      nbits_ = n;
-      bits_ = new V[nbits_];
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1)
-	    bits_[idx] = val;
+      allocate_(n);
+      fill_(val);
 }
 
 verinum::verinum(uint64_t val, unsigned n)
 : has_len_(true), has_sign_(false), is_single_(false), string_flag_(false)
 {
-      nbits_ = n;
-      bits_ = new V[nbits_];
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1) {
-	    bits_[idx] = (val&1) ? V1 : V0;
-	    val >>= (uint64_t)1;
+      allocate_(n);
+      for (unsigned idx = 0 ;  idx < nbits_ && idx < 64 ;  idx += BITS_PER_WORD)
+	    abits_[idx/BITS_PER_WORD] = (unsigned long)(val >> idx);
+
+      if (nbits_ % BITS_PER_WORD) {
+	    unsigned words = count_words(nbits_, BITS_PER_WORD);
+	    abits_[words-1] &= (1UL << (nbits_ % BITS_PER_WORD)) - 1UL;
       }
 }
 
@@ -180,9 +353,8 @@ verinum::verinum(double val, bool)
 
 	/* We return `bx for a NaN or +/- infinity. */
       if (val != val || (val && (val == 0.5*val))) {
-	    nbits_ = 1;
-	    bits_ = new V[nbits_];
-	    bits_[0] = Vx;
+	    allocate_(1);
+	    set(0, Vx);
 	    return;
       }
 
@@ -198,8 +370,7 @@ verinum::verinum(double val, bool)
 
 	/* Get the exponent and fractional part of the number. */
       fraction = frexp(val, &exponent);
-      nbits_ = exponent+1;
-      bits_ = new V[nbits_];
+      allocate_(exponent+1);
       const verinum const_one(1);
 
 	/* If the value is small enough just use lround(). */
@@ -207,7 +378,7 @@ verinum::verinum(double val, bool)
 	    long sval = lround(val);
 	    if (is_neg) sval = -sval;
 	    for (unsigned idx = 0; idx < nbits_; idx += 1) {
-		  bits_[idx] = (sval&1) ? V1 : V0;
+		  set(idx, (sval&1) ? V1 : V0);
 		  sval >>= 1;
 	    }
 	      /* Trim the result. */
@@ -223,7 +394,7 @@ verinum::verinum(double val, bool)
 	    unsigned long bits = (unsigned long) fraction;
 	    fraction = fraction - (double) bits;
 	    for (unsigned idx = 0; idx < nbits_; idx += 1) {
-		  bits_[idx] = (bits&1) ? V1 : V0;
+		  set(idx, (bits&1) ? V1 : V0);
 		  bits >>= 1;
 	    }
       } else {
@@ -233,7 +404,7 @@ verinum::verinum(double val, bool)
 		  unsigned max = (wd+1)*BITS_IN_LONG;
 		  if (max > nbits_) max = nbits_;
 		  for (unsigned idx = wd*BITS_IN_LONG; idx < max; idx += 1) {
-			bits_[idx] = (bits&1) ? V1 : V0;
+			set(idx, (bits&1) ? V1 : V0);
 			bits >>= 1;
 		  }
 		  fraction = ldexp(fraction, BITS_IN_LONG);
@@ -256,43 +427,41 @@ void verinum::signed_trim()
 {
 	/* Do we have any extra digits? */
       unsigned tlen = nbits_-1;
-      verinum::V sign = bits_[tlen];
-      while ((tlen > 0) && (bits_[tlen] == sign)) tlen -= 1;
+      verinum::V sign = get(tlen);
+      while ((tlen > 0) && (get(tlen) == sign)) tlen -= 1;
 
 	/* tlen now points to the first digit that is not the sign.
 	 * or bit 0. Set the length to include this bit and one proper
 	 * sign bit if needed. */
-      if (bits_[tlen] != sign) tlen += 1;
+      if (get(tlen) != sign) tlen += 1;
       tlen += 1;
 
 	/* Trim the bits if needed. */
       if (tlen < nbits_) {
-	    V* tbits = new V[tlen];
-	    for (unsigned idx = 0; idx < tlen; idx += 1)
-		  tbits[idx] = bits_[idx];
-	    delete[] bits_;
-	    bits_ = tbits;
-	    nbits_ = tlen;
+	    verinum tmp (*this, tlen);
+	    tmp.has_len_ = has_len_;
+	    tmp.is_single_ = is_single_;
+	    tmp.string_flag_ = string_flag_;
+	    *this = tmp;
       }
 }
 
 verinum::verinum(const verinum&that)
 {
       string_flag_ = that.string_flag_;
-      nbits_ = that.nbits_;
-      bits_ = new V[nbits_];
+      allocate_(that.nbits_);
       has_len_ = that.has_len_;
       has_sign_ = that.has_sign_;
       is_single_ = that.is_single_;
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1)
-	    bits_[idx] = that.bits_[idx];
+      unsigned words = count_words(nbits_, BITS_PER_WORD);
+      for (unsigned idx = 0 ;  idx < 2*words ;  idx += 1)
+	    abits_[idx] = that.abits_[idx];
 }
 
 verinum::verinum(const verinum&that, unsigned nbits)
 {
       string_flag_ = that.string_flag_ && (that.nbits_ == nbits);
-      nbits_ = nbits;
-      bits_ = new V[nbits_];
+      allocate_(nbits);
       has_len_ = true;
       has_sign_ = that.has_sign_;
       is_single_ = false;
@@ -300,17 +469,22 @@ verinum::verinum(const verinum&that, unsigned nbits)
       unsigned copy = nbits;
       if (copy > that.nbits_)
 	    copy = that.nbits_;
-      for (unsigned idx = 0 ;  idx < copy ;  idx += 1)
-	    bits_[idx] = that.bits_[idx];
 
-      if (copy < nbits_) {
-	    if (has_sign_ || that.is_single_) {
-		  for (unsigned idx = copy ;  idx < nbits_ ;  idx += 1)
-			bits_[idx] = bits_[idx-1];
-	    } else {
-		  for (unsigned idx = copy ;  idx < nbits_ ;  idx += 1)
-			bits_[idx] = verinum::V0;
-	    }
+      unsigned words = count_words(copy, BITS_PER_WORD);
+      for (unsigned idx = 0 ;  idx < words ;  idx += 1) {
+	    abits_[idx] = that.abits_[idx];
+	    bbits_[idx] = that.bbits_[idx];
+      }
+      if (copy % BITS_PER_WORD) {
+	    unsigned long mask = (1UL << (copy % BITS_PER_WORD)) - 1UL;
+	    abits_[words-1] &= mask;
+	    bbits_[words-1] &= mask;
+      }
+
+      if (copy < nbits_ && copy > 0 && (has_sign_ || that.is_single_)) {
+	    V pad = get(copy-1);
+	    for (unsigned idx = copy ;  idx < nbits_ ;  idx += 1)
+		  set(idx, pad);
       }
 }
 
@@ -321,34 +495,39 @@ verinum::verinum(int64_t that)
 
       if (that < 0) tmp = (that+1)/2;
       else tmp = that/2;
-      nbits_ = 1;
+      unsigned nbits = 1;
       while (tmp != 0) {
-	    nbits_ += 1;
+	    nbits += 1;
 	    tmp /= 2;
       }
 
-      nbits_ += 1;
+      nbits += 1;
 
-      bits_ = new V[nbits_];
+      allocate_(nbits);
       for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1) {
-	    bits_[idx] = (that & 1)? V1 : V0;
+	    set(idx, (that & 1)? V1 : V0);
 	    that >>= 1;
       }
 }
 
 verinum::~verinum()
 {
-      delete[]bits_;
+      delete[]abits_;
 }
 
 verinum& verinum::operator= (const verinum&that)
 {
       if (this == &that) return *this;
-      delete[]bits_;
+      unsigned words = count_words(that.nbits_, BITS_PER_WORD);
+      if (words != count_words(nbits_, BITS_PER_WORD)) {
+	    delete[]abits_;
+	    allocate_(that.nbits_);
+      }
       nbits_ = that.nbits_;
-      bits_ = new V[that.nbits_];
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1)
-	    bits_[idx] = that.bits_[idx];
+      for (unsigned idx = 0 ;  idx < words ;  idx += 1) {
+	    abits_[idx] = that.abits_[idx];
+	    bbits_[idx] = that.bbits_[idx];
+      }
 
       has_len_ = that.has_len_;
       has_sign_ = that.has_sign_;
@@ -359,21 +538,33 @@ verinum& verinum::operator= (const verinum&that)
 
 verinum::V verinum::get(unsigned idx) const
 {
+      static const V bit_table[4] = { V0, V1, Vz, Vx };
       assert(idx < nbits_);
-      return bits_[idx];
+      unsigned long a = abits_[idx/BITS_PER_WORD] >> (idx%BITS_PER_WORD);
+      unsigned long b = bbits_[idx/BITS_PER_WORD] >> (idx%BITS_PER_WORD);
+      return bit_table[((b&1) << 1) | (a&1)];
 }
 
 verinum::V verinum::set(unsigned idx, verinum::V val)
 {
       assert(idx < nbits_);
-      return bits_[idx] = val;
+      unsigned long mask = 1UL << (idx%BITS_PER_WORD);
+      unsigned long&a = abits_[idx/BITS_PER_WORD];
+      unsigned long&b = bbits_[idx/BITS_PER_WORD];
+
+      if (val == V1 || val == Vx) a |= mask;
+      else a &= ~mask;
+      if (val == Vx || val == Vz) b |= mask;
+      else b &= ~mask;
+
+      return val;
 }
 
 void verinum::set(unsigned off, const verinum&val)
 {
       assert(off + val.len() <= nbits_);
       for (unsigned idx = 0 ; idx < val.len() ; idx += 1)
-	    bits_[off+idx] = val[idx];
+	    set(off+idx, val[idx]);
 }
 
 unsigned long verinum::as_ulong() const
@@ -384,17 +575,7 @@ unsigned long verinum::as_ulong() const
       if (!is_defined())
 	    return 0;
 
-      unsigned top = nbits_;
-      if (top >= (8 * sizeof(unsigned long)))
-	  top = 8 * sizeof(unsigned long);
-
-      unsigned long val = 0;
-      unsigned long mask = 1;
-      for (unsigned idx = 0 ;  idx < top ;  idx += 1, mask <<= 1)
-	    if (bits_[idx] == V1)
-		  val |= mask;
-
-      return val;
+      return abits_[0];
 }
 
 uint64_t verinum::as_ulong64() const
@@ -405,15 +586,10 @@ uint64_t verinum::as_ulong64() const
       if (!is_defined())
 	    return 0;
 
-      unsigned top = nbits_;
-      if (top >= (8 * sizeof(uint64_t)))
-	  top = 8 * sizeof(uint64_t);
-
       uint64_t val = 0;
-      uint64_t mask = 1;
-      for (unsigned idx = 0 ;  idx < top ;  idx += 1, mask <<= 1)
-	    if (bits_[idx] == V1)
-		  val |= mask;
+      unsigned words = count_words(nbits_, BITS_PER_WORD);
+      for (unsigned idx = 0 ;  idx < words && idx*BITS_PER_WORD < 64 ;  idx += 1)
+	    val |= (uint64_t)abits_[idx] << (idx*BITS_PER_WORD);
 
       return val;
 }
@@ -448,26 +624,21 @@ signed long verinum::as_long() const
       }
       int lost_bits=0;
 
-      if (has_sign_ && (bits_[nbits_-1] == V1)) {
-	    val = -1;
-	    signed long mask = ~1L;
-	    for (unsigned idx = 0 ;  idx < top ;  idx += 1) {
-		  if (bits_[idx] == V0) val &= mask;
-		  mask = (mask << 1) | 1L;
-	    }
+	/* The low bits all fit in the first word. */
+      unsigned long low = abits_[0] & ((1UL << top) - 1UL);
+
+      if (has_sign_ && (get(nbits_-1) == V1)) {
+	    val = (signed long) (low | (-1UL << top));
 	    if (diag_top) {
 		  for (unsigned idx = top; idx < diag_top; idx += 1) {
-			if (bits_[idx] == V0) lost_bits=1;
+			if (get(idx) == V0) lost_bits=1;
 		  }
 	    }
       } else {
-	    signed long mask = 1;
-	    for (unsigned idx = 0 ;  idx < top ;  idx += 1, mask <<= 1) {
-		  if (bits_[idx] == V1) val |= mask;
-	    }
+	    val = (signed long) low;
 	    if (diag_top) {
 		  for (unsigned idx = top; idx < diag_top; idx += 1) {
-			if (bits_[idx] == V1) lost_bits=1;
+			if (get(idx) == V1) lost_bits=1;
 		  }
 	    }
       }
@@ -484,17 +655,17 @@ double verinum::as_double() const
 
       double val = 0.0;
         /* Do we have/want a signed value? */
-      if (has_sign_ && bits_[nbits_-1] == V1) {
+      if (has_sign_ && get(nbits_-1) == V1) {
 	    V carry = V1;
 	    for (unsigned idx = 0; idx < nbits_; idx += 1) {
-		  V sum = add_with_carry(~bits_[idx], V0, carry);
+		  V sum = add_with_carry(~get(idx), V0, carry);
 		  if (sum == V1)
 			val += pow(2.0, (double)idx);
 	    }
 	    val *= -1.0;
       } else {
 	    for (unsigned idx = 0; idx < nbits_; idx += 1) {
-		  if (bits_[idx] == V1)
+		  if (get(idx) == V1)
 			val += pow(2.0, (double)idx);
 	    }
       }
@@ -509,17 +680,11 @@ string verinum::as_string() const
 
       string res;
       for (unsigned idx = nbits_ ;  idx > 0 ;  idx -= 8) {
-	    char char_val = 0;
-	    V*bp = bits_+idx;
-
-	    if (*(--bp) == V1) char_val |= 0x80;
-	    if (*(--bp) == V1) char_val |= 0x40;
-	    if (*(--bp) == V1) char_val |= 0x20;
-	    if (*(--bp) == V1) char_val |= 0x10;
-	    if (*(--bp) == V1) char_val |= 0x08;
-	    if (*(--bp) == V1) char_val |= 0x04;
-	    if (*(--bp) == V1) char_val |= 0x02;
-	    if (*(--bp) == V1) char_val |= 0x01;
+	    unsigned off = idx - 8;
+	      /* Bytes never straddle a word, and X/Z bits read as 0. */
+	    unsigned long byte = (abits_[off/BITS_PER_WORD] & ~bbits_[off/BITS_PER_WORD])
+		  >> (off%BITS_PER_WORD);
+	    char char_val = (char) (byte & 0xff);
 
 	    if (char_val == '"' || char_val == '\\') {
 		  char tmp[5];
@@ -542,39 +707,41 @@ bool verinum::is_before(const verinum&that) const
       if (that.nbits_ < nbits_) return false;
 
       for (unsigned idx = nbits_  ;  idx > 0 ;  idx -= 1) {
-	    if (bits_[idx-1] < that.bits_[idx-1]) return true;
-	    if (bits_[idx-1] > that.bits_[idx-1]) return false;
+	    if (get(idx-1) < that.get(idx-1)) return true;
+	    if (get(idx-1) > that.get(idx-1)) return false;
       }
       return false;
 }
 
 bool verinum::is_defined() const
 {
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1) {
-	    if (bits_[idx] == Vx) return false;
-	    if (bits_[idx] == Vz) return false;
+      unsigned words = count_words(nbits_, BITS_PER_WORD);
+      for (unsigned idx = 0 ;  idx < words ;  idx += 1) {
+	    if (bbits_[idx] != 0) return false;
       }
       return true;
 }
 
 bool verinum::is_zero() const
 {
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1)
-	    if (bits_[idx] != V0) return false;
+      unsigned words = count_words(nbits_, BITS_PER_WORD);
+      for (unsigned idx = 0 ;  idx < words ;  idx += 1)
+	    if (abits_[idx] != 0 || bbits_[idx] != 0) return false;
 
       return true;
 }
 
 bool verinum::is_negative() const
 {
-      return (bits_[nbits_-1] == V1) && has_sign();
+      return (get(nbits_-1) == V1) && has_sign();
 }
 
 void verinum::cast_to_int2()
 {
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1) {
-	    if (bits_[idx] == Vx || bits_[idx] == Vz)
-		  bits_[idx] = V0;
+      unsigned words = count_words(nbits_, BITS_PER_WORD);
+      for (unsigned idx = 0 ;  idx < words ;  idx += 1) {
+	    abits_[idx] &= ~bbits_[idx];
+	    bbits_[idx] = 0;
       }
 }
 
@@ -789,8 +956,40 @@ ostream& operator<< (ostream&o, const verinum&v)
       return o;
 }
 
+/*
+ * Compare two values of the same number of words. The result is <0,
+ * 0 or >0 like memcmp. The values compare as unsigned, so the caller
+ * checks the sign bits of signed values.
+ */
+static int compare_words(const unsigned long*lval, const unsigned long*rval,
+			 unsigned words)
+{
+      for (unsigned idx = words ;  idx > 0 ;  idx -= 1) {
+	    if (lval[idx-1] < rval[idx-1]) return -1;
+	    if (lval[idx-1] > rval[idx-1]) return 1;
+      }
+      return 0;
+}
+
 verinum::V operator == (const verinum&left, const verinum&right)
 {
+      if (left.len() > 0 && right.len() > 0
+	  && left.is_defined() && right.is_defined()) {
+	    unsigned max_len = left.len();
+	    if (right.len() > max_len)
+		  max_len = right.len();
+	    unsigned words = (max_len + verinum::BITS_PER_WORD - 1)
+		  / verinum::BITS_PER_WORD;
+	    unsigned long*lval = new unsigned long[2*words];
+	    unsigned long*rval = lval + words;
+	    bool sext = left.has_sign() && right.has_sign();
+	    left.to_words_(lval, max_len, sext);
+	    right.to_words_(rval, max_len, sext);
+	    int rc = compare_words(lval, rval, words);
+	    delete[]lval;
+	    return rc == 0? verinum::V1 : verinum::V0;
+      }
+
       verinum::V left_pad = verinum::V0;
       verinum::V right_pad = verinum::V0;
       if (left.has_sign() && right.has_sign()) {
@@ -832,6 +1031,25 @@ verinum::V operator <= (const verinum&left, const verinum&right)
 		  return verinum::V0;
       }
 
+	/* With the sign bits equal, the extended values of defined
+	   operands compare as unsigned words. */
+      if (left.len() > 0 && right.len() > 0
+	  && left.is_defined() && right.is_defined()) {
+	    unsigned max_len = left.len();
+	    if (right.len() > max_len)
+		  max_len = right.len();
+	    unsigned words = (max_len + verinum::BITS_PER_WORD - 1)
+		  / verinum::BITS_PER_WORD;
+	    unsigned long*lval = new unsigned long[2*words];
+	    unsigned long*rval = lval + words;
+	    left.to_words_(lval, max_len, signed_calc);
+	    right.to_words_(rval, max_len, signed_calc);
+	    int rc = compare_words(lval, rval, words);
+	    delete[]lval;
+	    if (rc == 0) return verinum::V1;
+	    return rc < 0? verinum::V1 : verinum::V0;
+      }
+
       unsigned idx;
       for (idx = left.len() ; idx > right.len() ;  idx -= 1) {
 	    if (left[idx-1] != right_pad) {
@@ -884,6 +1102,25 @@ verinum::V operator < (const verinum&left, const verinum&right)
 		  return verinum::V0;
       }
 
+	/* With the sign bits equal, the extended values of defined
+	   operands compare as unsigned words. */
+      if (left.len() > 0 && right.len() > 0
+	  && left.is_defined() && right.is_defined()) {
+	    unsigned max_len = left.len();
+	    if (right.len() > max_len)
+		  max_len = right.len();
+	    unsigned words = (max_len + verinum::BITS_PER_WORD - 1)
+		  / verinum::BITS_PER_WORD;
+	    unsigned long*lval = new unsigned long[2*words];
+	    unsigned long*rval = lval + words;
+	    left.to_words_(lval, max_len, signed_calc);
+	    right.to_words_(rval, max_len, signed_calc);
+	    int rc = compare_words(lval, rval, words);
+	    delete[]lval;
+	    if (rc == 0) return verinum::V0;
+	    return rc < 0? verinum::V1 : verinum::V0;
+      }
+
       unsigned idx;
       for (idx = left.len() ; idx > right.len() ;  idx -= 1) {
 	    if (left[idx-1] != right_pad) {
@@ -969,18 +1206,16 @@ static verinum::V add_with_carry(verinum::V l, verinum::V r, verinum::V&c)
 verinum v_not(const verinum&left)
 {
       verinum val = left;
-      for (unsigned idx = 0 ;  idx < val.len() ;  idx += 1)
-	    switch (val[idx]) {
-		case verinum::V0:
-		  val.set(idx, verinum::V1);
-		  break;
-		case verinum::V1:
-		  val.set(idx, verinum::V0);
-		  break;
-		default:
-		  val.set(idx, verinum::Vx);
-		  break;
-	    }
+      if (val.nbits_ == 0)
+	    return val;
+
+	/* 0 and 1 bits invert, and x and z bits become x. */
+      unsigned words = count_words(val.nbits_, verinum::BITS_PER_WORD);
+      for (unsigned idx = 0 ;  idx < words ;  idx += 1)
+	    val.abits_[idx] = ~val.abits_[idx] | val.bbits_[idx];
+
+      if (val.nbits_ % verinum::BITS_PER_WORD)
+	    val.abits_[words-1] &= (1UL << (val.nbits_ % verinum::BITS_PER_WORD)) - 1UL;
 
       return val;
 }
@@ -1001,6 +1236,22 @@ verinum operator + (const verinum&left, const verinum&right)
       if (right.len() > max) max = right.len();
 
       bool signed_flag = left.has_sign() && right.has_sign();
+
+      if (min > 0 && left.is_defined() && right.is_defined()) {
+	    unsigned words = count_words(max+1, verinum::BITS_PER_WORD);
+	    unsigned long*lval = new unsigned long[2*words];
+	    unsigned long*rval = lval + words;
+	    left.to_words_(lval, max+1, signed_flag);
+	    right.to_words_(rval, max+1, signed_flag);
+	    add_words(lval, lval, rval, 0, words);
+
+	    verinum val (verinum::V0, max+1, false);
+	    val.from_words_(lval);
+	    val.has_sign(signed_flag);
+	    delete[]lval;
+	    return val;
+      }
+
       verinum::V*val_bits = new verinum::V[max+1];
 
       verinum::V carry = verinum::V0;
@@ -1045,6 +1296,37 @@ verinum operator - (const verinum&left, const verinum&right)
       if (right.len() > max) max = right.len();
 
       bool signed_flag = left.has_sign() && right.has_sign();
+
+	/* The difference is calculated one bit wider than the
+	   operands. A signed result keeps that bit only if it is
+	   needed to hold the sign. */
+      if (min > 0 && left.is_defined() && right.is_defined()) {
+	    unsigned words = count_words(max+1, verinum::BITS_PER_WORD);
+	    unsigned long*lval = new unsigned long[2*words];
+	    unsigned long*rval = lval + words;
+	    left.to_words_(lval, max+1, signed_flag);
+	    right.to_words_(rval, max+1, signed_flag);
+	    for (unsigned idx = 0 ;  idx < words ;  idx += 1)
+		  rval[idx] = ~rval[idx];
+	    add_words(lval, lval, rval, 1, words);
+
+	    unsigned wid = max;
+	    if (signed_flag) {
+		  unsigned long top = lval[max/verinum::BITS_PER_WORD]
+			>> (max%verinum::BITS_PER_WORD);
+		  unsigned long next = lval[(max-1)/verinum::BITS_PER_WORD]
+			>> ((max-1)%verinum::BITS_PER_WORD);
+		  if ((top ^ next) & 1UL)
+			wid += 1;
+	    }
+
+	    verinum val (verinum::V0, wid, false);
+	    val.from_words_(lval);
+	    val.has_sign(signed_flag);
+	    delete[]lval;
+	    return val;
+      }
+
       verinum::V*val_bits = new verinum::V[max+1];
 
       verinum::V carry = verinum::V1;
@@ -1084,8 +1366,8 @@ verinum operator - (const verinum&left, const verinum&right)
  * result. The resulting number is as large as the sum of the sizes of
  * the operand.
  *
- * The algorithm used is successive shift and add operations,
- * implemented as the nested loops.
+ * The operands are extended (by their own signedness) to the result
+ * width and multiplied a half word digit at a time.
  *
  * If either value is not completely defined, then the result is not
  * defined either.
@@ -1106,22 +1388,19 @@ verinum operator * (const verinum&left, const verinum&right)
       verinum result(verinum::V0, left.len() + right.len(), has_len_flag);
       result.has_sign(left.has_sign() || right.has_sign());
 
-      verinum::V r_sign = sign_bit(right);
-      for (unsigned rdx = 0 ;  rdx < result.len() ;  rdx += 1) {
-
-	    verinum::V r_bit = rdx < right.len()? right.get(rdx) : r_sign;
-	    if (r_bit == verinum::V0)
-		  continue;
+      unsigned wid = result.len();
+      if (wid == 0)
+	    return result;
 
-	    verinum::V l_sign = sign_bit(left);
-	    verinum::V carry = verinum::V0;
-	    for (unsigned ldx = 0 ;  ldx < result.len()-rdx ;  ldx += 1) {
-		  verinum::V l_bit = ldx < left.len()? left[ldx] : l_sign;
-		  result.set(ldx+rdx, add_with_carry(l_bit,
-						     result[rdx+ldx],
-						     carry));
-	    }
-      }
+      unsigned words = count_words(wid, verinum::BITS_PER_WORD);
+      unsigned long*lval = new unsigned long[3*words];
+      unsigned long*rval = lval + words;
+      unsigned long*pval = rval + words;
+      left.to_words_(lval, wid, left.has_sign());
+      right.to_words_(rval, wid, right.has_sign());
+      mul_words(pval, lval, rval, words);
+      result.from_words_(pval);
+      delete[]lval;
 
       return trim_vnum(result);
 }
@@ -1180,8 +1459,19 @@ verinum operator << (const verinum&that, unsigned shift)
       verinum result(verinum::V0, that.len() + shift, that.has_len());
       result.has_sign(that.has_sign());
 
-      for (unsigned idx = 0 ;  idx < that.len() ;  idx += 1)
-	    result.set(idx+shift, that.get(idx));
+      const unsigned wshift = shift / verinum::BITS_PER_WORD;
+      const unsigned bshift = shift % verinum::BITS_PER_WORD;
+      unsigned words = count_words(that.nbits_, verinum::BITS_PER_WORD);
+      unsigned rwords = count_words(result.nbits_, verinum::BITS_PER_WORD);
+      for (unsigned idx = 0 ;  idx < words ;  idx += 1) {
+	    result.abits_[idx+wshift] |= that.abits_[idx] << bshift;
+	    result.bbits_[idx+wshift] |= that.bbits_[idx] << bshift;
+	    if (bshift && idx+wshift+1 < rwords) {
+		  unsigned rshift = verinum::BITS_PER_WORD - bshift;
+		  result.abits_[idx+wshift+1] |= that.abits_[idx] >> rshift;
+		  result.bbits_[idx+wshift+1] |= that.bbits_[idx] >> rshift;
+	    }
+      }
 
       return result;
 }
@@ -1199,17 +1489,43 @@ verinum operator >> (const verinum&that, unsigned shift)
 	    }
       }
 
-      verinum result(that.has_sign()? that.get(that.len()-1) : verinum::V0,
-		     that.len() - shift, that.has_len());
+      verinum result(verinum::V0, that.len() - shift, that.has_len());
       result.has_sign(that.has_sign());
 
-      for (unsigned idx = shift ;  idx < that.len() ;  idx += 1)
-	    result.set(idx-shift, that.get(idx));
+	/* Every bit of the result comes from the source, so there is
+	   no padding to fill in. */
+      const unsigned wshift = shift / verinum::BITS_PER_WORD;
+      const unsigned bshift = shift % verinum::BITS_PER_WORD;
+      unsigned words = count_words(that.nbits_, verinum::BITS_PER_WORD);
+      unsigned rwords = count_words(result.nbits_, verinum::BITS_PER_WORD);
+      for (unsigned idx = 0 ;  idx < rwords ;  idx += 1) {
+	    unsigned long a = that.abits_[idx+wshift] >> bshift;
+	    unsigned long b = that.bbits_[idx+wshift] >> bshift;
+	    if (bshift && idx+wshift+1 < words) {
+		  unsigned lshift = verinum::BITS_PER_WORD - bshift;
+		  a |= that.abits_[idx+wshift+1] << lshift;
+		  b |= that.bbits_[idx+wshift+1] << lshift;
+	    }
+	    result.abits_[idx] = a;
+	    result.bbits_[idx] = b;
+      }
+
+      if (result.nbits_ % verinum::BITS_PER_WORD) {
+	    unsigned long mask = (1UL << (result.nbits_ % verinum::BITS_PER_WORD)) - 1UL;
+	    result.abits_[rwords-1] &= mask;
+	    result.bbits_[rwords-1] &= mask;
+      }
 
       return result;
 }
 
-static verinum unsigned_divide(verinum num, verinum den, bool signed_result)
+/*
+ * Divide two positive, defined values. The quotient is just wide
+ * enough to hold the result, plus a sign bit if signed_result is
+ * true.
+ */
+verinum verinum::unsigned_divide_(const verinum&num, const verinum&den,
+				  bool signed_result)
 {
       unsigned nwid = num.len();
       while (nwid > 0 && (num.get(nwid-1) == verinum::V0))
@@ -1222,28 +1538,31 @@ static verinum unsigned_divide(verinum num, verinum den, bool signed_result)
       if (dwid > nwid)
 	    return verinum(verinum::V0, 1);
 
-      den = den << (nwid-dwid);
+	/* Work wide enough for the result as well as the operands. */
+      unsigned wid = num.len() + 1;
+      unsigned words = count_words(wid, BITS_PER_WORD);
+      unsigned long*nval = new unsigned long[3*words];
+      unsigned long*dval = nval + words;
+      unsigned long*qval = dval + words;
+      num.to_words_(nval, wid, false);
+      den.to_words_(dval, wid, false);
+      divide_words(nval, dval, words, qval, 0);
 
       unsigned idx = nwid - dwid + 1;
       verinum result (verinum::V0, signed_result ? idx + 1 : idx);
-      if (signed_result) {
-	    result.set(idx, verinum::V0);
+      if (signed_result)
 	    result.has_sign(true);
-      }
-      while (idx > 0) {
-	    if (den <= num) {
-		  verinum dif = num - den;
-		  num = dif;
-		  result.set(idx-1, verinum::V1);
-	    }
-	    den = den >> 1;
-	    idx -= 1;
-      }
+      result.from_words_(qval);
+      delete[]nval;
 
       return result;
 }
 
-static verinum unsigned_modulus(verinum num, verinum den)
+/*
+ * The remainder of two positive, defined values. If the numerator is
+ * already less than the denominator it is returned as is.
+ */
+verinum verinum::unsigned_modulus_(const verinum&num, const verinum&den)
 {
       unsigned nwid = num.len();
       while (nwid > 0 && (num.get(nwid-1) == verinum::V0))
@@ -1256,19 +1575,28 @@ static verinum unsigned_modulus(verinum num, verinum den)
       if (dwid > nwid)
 	    return num;
 
-      den = den << (nwid-dwid);
-
-      unsigned idx = nwid - dwid + 1;
-      while (idx > 0) {
-	    if (den <= num) {
-		  verinum dif = num - den;
-		  num = dif;
-	    }
-	    den = den >> 1;
-	    idx -= 1;
+	/* Work wide enough for the result as well as the operands. */
+      unsigned wid = num.len() + 1;
+      unsigned words = count_words(wid, BITS_PER_WORD);
+      unsigned long*nval = new unsigned long[3*words];
+      unsigned long*dval = nval + words;
+      unsigned long*rval = dval + words;
+      num.to_words_(nval, wid, false);
+      den.to_words_(dval, wid, false);
+
+      if (compare_words(nval, dval, words) < 0) {
+	    delete[]nval;
+	    return num;
       }
 
-      return num;
+      divide_words(nval, dval, words, 0, rval);
+
+      verinum result (verinum::V0, num.len(), false);
+      result.has_sign(num.has_sign() && den.has_sign());
+      result.from_words_(rval);
+      delete[]nval;
+
+      return result;
 }
 
 /*
@@ -1332,7 +1660,7 @@ verinum operator / (const verinum&left, const verinum&right)
 		  } else {
 			use_right = right;
 		  }
-		  result = unsigned_divide(use_left, use_right, true);
+		  result = verinum::unsigned_divide_(use_left, use_right, true);
 		  if (negative) result = zero - result;
 	    }
 
@@ -1350,7 +1678,7 @@ verinum operator / (const verinum&left, const verinum&right)
 		  }
 
 	    } else {
-		  result = unsigned_divide(left, right, false);
+		  result = verinum::unsigned_divide_(left, right, false);
 	    }
       }
 
@@ -1409,7 +1737,7 @@ verinum operator % (const verinum&left, const verinum&right)
 		  } else {
 			use_right = right;
 		  }
-		  result = unsigned_modulus(use_left, use_right);
+		  result = verinum::unsigned_modulus_(use_left, use_right);
 		  result.has_sign(true);
 		  if (negative) result = zero - result;
 	    }
@@ -1424,7 +1752,7 @@ verinum operator % (const verinum&left, const verinum&right)
 			v >>= 1;
 		  }
 	    } else {
-		  result = unsigned_modulus(left, right);
+		  result = verinum::unsigned_modulus_(left, right);
 	    }
       }
 
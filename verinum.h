@@ -105,9 +105,37 @@ class verinum {
       string as_string() const;
     private:
       void signed_trim();
+      void allocate_(unsigned nbits);
+      void fill_(V val);
+	// Get the (defined) value as words, truncated or extended
+	// to wid bits, and set the value from words.
+      void to_words_(unsigned long*val, unsigned wid, bool sext) const;
+      void from_words_(const unsigned long*val);
+
+      static verinum unsigned_divide_(const verinum&num, const verinum&den,
+				      bool signed_result);
+      static verinum unsigned_modulus_(const verinum&num, const verinum&den);
+
+      friend verinum::V operator == (const verinum&, const verinum&);
+      friend verinum::V operator <= (const verinum&, const verinum&);
+      friend verinum::V operator <  (const verinum&, const verinum&);
+      friend verinum operator + (const verinum&, const verinum&);
+      friend verinum operator - (const verinum&, const verinum&);
+      friend verinum operator * (const verinum&, const verinum&);
+      friend verinum operator / (const verinum&, const verinum&);
+      friend verinum operator % (const verinum&, const verinum&);
+      friend verinum operator<< (const verinum&, unsigned);
+      friend verinum operator>> (const verinum&, unsigned);
+      friend verinum v_not(const verinum&);
 
     private:
-      V* bits_;
+	// The bits are packed into words, with the same encoding as
+	// the vvp runtime: abits_ holds the value bits and bbits_ the
+	// x/z bits, so 0=00, 1=10, x=11 and z=01 (a,b). The bits above
+	// nbits_ in the top word are always 0.
+      enum { BITS_PER_WORD = 8 * sizeof(unsigned long) };
+      unsigned long*abits_;
+      unsigned long*bbits_;
       unsigned nbits_;
       bool has_len_;
       bool has_sign_;
@@ -25,7 +25,12 @@
 #include "fstapi.h"
 #include "fastlz.h"
 
-#ifndef HAVE_LIBPTHREAD
+/* The parallel writer is only used if fstWriterSetParallelMode() turns it on. */
+#ifdef HAVE_LIBPTHREAD
+#ifndef FST_WRITER_PARALLEL
+#define FST_WRITER_PARALLEL
+#endif
+#else
 #undef FST_WRITER_PARALLEL
 #endif
 
@@ -601,6 +606,9 @@ fstHandle next_huge_break;
 Pvoid_t path_array;
 uint32_t path_array_count;
 
+char *vec4_buf;			/* scratch for fstWriterEmitValueChangeVec4() */
+uint32_t vec4_buf_siz;
+
 unsigned fseek_failed : 1;
 };
 
@@ -1875,6 +1883,7 @@ if(xc && !xc->already_in_close && !xc->already_in_flush)
 		JudyHSFreeArray(&(xc->path_array), NULL);
 		}
 
+	free(xc->vec4_buf); xc->vec4_buf = NULL;
 	free(xc->filename); xc->filename = NULL;
 	free(xc);
 	}
@@ -2524,6 +2533,55 @@ if((xc) && (handle <= xc->maxhandle))
 }
 
 
+/*
+ * packed 4-state value change: val holds aval/bval pairs of 32-bit words,
+ * least significant word first, using the Verilog PLI s_vpi_vecval
+ * encoding (0 = 0/0, 1 = 1/0, z = 0/1, x = 1/1).  This saves the caller
+ * from building the ASCII value string.
+ */
+void fstWriterEmitValueChangeVec4(void *ctx, fstHandle handle, uint32_t bits, const uint32_t *val)
+{
+struct fstWriterContext *xc = (struct fstWriterContext *)ctx;
+
+if((xc) && (bits))
+	{
+	static const char vec4_chars[4] = { '0', '1', 'z', 'x' };
+	char *s;
+	uint32_t i;
+
+	if(bits > xc->vec4_buf_siz)
+		{
+		free(xc->vec4_buf);
+		xc->vec4_buf = malloc(bits);
+		if(!xc->vec4_buf)
+			{
+			fprintf(stderr, "FATAL ERROR, could not malloc() in fstWriterEmitValueChangeVec4, exiting.\n");
+			exit(255);
+			}
+		xc->vec4_buf_siz = bits;
+		}
+
+	s = xc->vec4_buf + bits; /* the string is msb first, so fill it from the end */
+	for(i=0;i<bits;i+=32)
+		{
+		uint32_t aval = *(val++);
+		uint32_t bval = *(val++);
+		uint32_t cnt = ((bits - i) < 32) ? (bits - i) : 32;
+		uint32_t j;
+
+		for(j=0;j<cnt;j++)
+			{
+			*(--s) = vec4_chars[((bval & 1) << 1) | (aval & 1)];
+			aval >>= 1;
+			bval >>= 1;
+			}
+		}
+
+	fstWriterEmitValueChange(xc, handle, xc->vec4_buf);
+	}
+}
+
+
 void fstWriterEmitVariableLengthValueChange(void *ctx, fstHandle handle, const void *val, uint32_t len)
 {
 struct fstWriterContext *xc = (struct fstWriterContext *)ctx;
@@ -324,6 +324,7 @@ fstHandle 	fstWriterCreateVar2(void *ctx, enum fstVarType vt, enum fstVarDir vd,
         		uint32_t len, const char *nam, fstHandle aliasHandle,
 			const char *type, enum fstSupplementalVarType svt, enum fstSupplementalDataType sdt);
 void 		fstWriterEmitValueChange(void *ctx, fstHandle handle, const void *val);
+void 		fstWriterEmitValueChangeVec4(void *ctx, fstHandle handle, uint32_t bits, const uint32_t *val);
 void 		fstWriterEmitVariableLengthValueChange(void *ctx, fstHandle handle, const void *val, uint32_t len);
 void 		fstWriterEmitDumpActive(void *ctx, int enable);
 void 		fstWriterEmitTimeChange(void *ctx, uint64_t tim);
@@ -65,6 +65,34 @@ static PLI_INT32 my_mcd_printf(PLI_UINT32 mcd, const char *fmt, ...)
       return r;
 }
 
+/*
+ * Write a formatted result of the given size. The result may contain
+ * embedded NULL characters (from %u and %z), so it can not be printed
+ * as a single string. A file descriptor is written directly with
+ * fwrite(). A MCD can only be written through the printf interface, so
+ * it is printed a string at a time.
+ */
+static void my_mcd_write(PLI_UINT32 mcd, const char *buf, unsigned size)
+{
+      unsigned location = 0;
+
+      if (! IS_MCD(mcd)) {
+	    FILE *fp = vpi_get_file(mcd);
+	    if (fp) fwrite(buf, 1, size, fp);
+	    return;
+      }
+
+      while (location < size) {
+	    if (buf[location] == '\0') {
+		  my_mcd_printf(mcd, "%c", '\0');
+		  location += 1;
+	    } else {
+		  my_mcd_printf(mcd, "%s", &buf[location]);
+		  location += strlen(&buf[location]);
+	    }
+      }
+}
+
 struct timeformat_info_s timeformat_info = { 0, 0, 0, 20 };
 
 struct strobe_cb_info {
@@ -902,20 +930,20 @@ static unsigned int get_numeric(char **rtn, const struct strobe_cb_info *info,
   return strlen(*rtn);
 }
 
-/* In many places we can't use the normal str functions since %u and %z
- * can insert NULL characters into the stream. */
-static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
+/* Format the display item at *idx (and any items consumed by its format
+ * string) into a newly allocated buffer. On return *idx refers to the
+ * last item used. The result is not null terminated since %u and %z can
+ * insert NULL characters into the stream. */
+static unsigned int get_display_item(char **rtn,
+                                     const struct strobe_cb_info *info,
+                                     unsigned int *idx)
 {
-  char *result, *fmt, *rtn, *func_name;
+  char *result, *fmt, *func_name;
   const char *cresult;
   s_vpi_value value;
-  unsigned int idx, size, width;
+  unsigned int width;
   char buf[256];
-
-  rtn = strdup("");
-  size = 1;
-  for  (idx = 0; idx < info->nitems; idx += 1) {
-    vpiHandle item = info->items[idx];
+  vpiHandle item = info->items[*idx];
 
     switch (vpi_get(vpiType, item)) {
 
@@ -925,7 +953,7 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
           value.format = vpiStringVal;
           vpi_get_value(item, &value);
           fmt = strdup(value.value.str);
-          width = get_format(&result, fmt, info, &idx);
+          width = get_format(&result, fmt, info, idx);
           free(fmt);
         } else if (vpi_get(vpiConstType, item) == vpiRealConst) {
           value.format = vpiRealVal;
@@ -936,9 +964,6 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
         } else {
           width = get_numeric(&result, info, item);
         }
-        rtn = realloc(rtn, (size+width)*sizeof(char));
-        memcpy(rtn+size-1, result, width);
-        free(result);
         break;
 
       case vpiNet:
@@ -952,9 +977,6 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
       case vpiMemoryWord:
       case vpiPartSelect:
         width = get_numeric(&result, info, item);
-        rtn = realloc(rtn, (size+width)*sizeof(char));
-        memcpy(rtn+size-1, result, width);
-        free(result);
         break;
 
       /* It appears that this is not currently used! A time variable is
@@ -967,8 +989,8 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
                  vpi_get(vpiTimeUnit, info->scope));
         width = strlen(buf);
         if (width  < timeformat_info.width) width = timeformat_info.width;
-        rtn = realloc(rtn, (size+width)*sizeof(char));
-        sprintf(rtn+size-1, "%*s", width, buf);
+        result = malloc((width+1)*sizeof(char));
+        sprintf(result, "%*s", width, buf);
         break;
 
       /* Realtime variables are also processed here. */
@@ -976,9 +998,8 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
         value.format = vpiRealVal;
         vpi_get_value(item, &value);
         sprintf(buf, compatible_flag ? "%g" : "%#g", value.value.real);
-        width = strlen(buf);
-        rtn = realloc(rtn, (size+width)*sizeof(char));
-        memcpy(rtn+size-1, buf, width);
+        result = strdup(buf);
+        width = strlen(result);
         break;
 
        /* Process string variables like string constants: interpret
@@ -987,11 +1008,8 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
 	value.format = vpiStringVal;
 	vpi_get_value(item, &value);
 	fmt = strdup(value.value.str);
-	width = get_format(&result, fmt, info, &idx);
+	width = get_format(&result, fmt, info, idx);
 	free(fmt);
-        rtn = realloc(rtn, (size+width)*sizeof(char));
-        memcpy(rtn+size-1, result, width);
-        free(result);
 	break;
 
       case vpiSysFuncCall:
@@ -1001,24 +1019,24 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
           vpi_get_value(item, &value);
           width = strlen(value.value.str);
           if (width  < 20) width = 20;
-          rtn = realloc(rtn, (size+width)*sizeof(char));
-          sprintf(rtn+size-1, "%*s", width, value.value.str);
+          result = malloc((width+1)*sizeof(char));
+          sprintf(result, "%*s", width, value.value.str);
 
         } else if (strcmp(func_name, "$stime") == 0) {
           value.format = vpiDecStrVal;
           vpi_get_value(item, &value);
           width = strlen(value.value.str);
           if (width  < 10) width = 10;
-          rtn = realloc(rtn, (size+width)*sizeof(char));
-          sprintf(rtn+size-1, "%*s", width, value.value.str);
+          result = malloc((width+1)*sizeof(char));
+          sprintf(result, "%*s", width, value.value.str);
 
         } else if (strcmp(func_name, "$simtime") == 0) {
           value.format = vpiDecStrVal;
           vpi_get_value(item, &value);
           width = strlen(value.value.str);
           if (width  < 20) width = 20;
-          rtn = realloc(rtn, (size+width)*sizeof(char));
-          sprintf(rtn+size-1, "%*s", width, value.value.str);
+          result = malloc((width+1)*sizeof(char));
+          sprintf(result, "%*s", width, value.value.str);
 
         } else if (strcmp(func_name, "$realtime") == 0) {
           /* Use the local scope precision. */
@@ -1028,17 +1046,14 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
           value.format = vpiRealVal;
           vpi_get_value(item, &value);
           sprintf(buf, "%.*f", use_prec, value.value.real);
-          width = strlen(buf);
-          rtn = realloc(rtn, (size+width)*sizeof(char));
-          sprintf(rtn+size-1, "%*s", width, buf);
+          result = strdup(buf);
+          width = strlen(result);
 
         } else {
           vpi_printf("WARNING: %s:%d: %s does not support %s as an argument!\n",
                      info->filename, info->lineno, info->name, func_name);
-          strcpy(buf, "<?>");
-          width = strlen(buf);
-          rtn = realloc(rtn, (size+width)*sizeof(char));
-          memcpy(rtn+size-1, buf, width);
+          result = strdup("<?>");
+          width = strlen(result);
         }
         break;
 
@@ -1047,11 +1062,29 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
                    info->filename, info->lineno, vpi_get_str(vpiType, item),
                    info->name);
         cresult = "<?>";
+        result = strdup(cresult);
         width = strlen(cresult);
-        rtn = realloc(rtn, (size+width)*sizeof(char));
-        memcpy(rtn+size-1, cresult, width);
         break;
     }
+
+  *rtn = result;
+  return width;
+}
+
+/* In many places we can't use the normal str functions since %u and %z
+ * can insert NULL characters into the stream. */
+static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
+{
+  char *result, *rtn;
+  unsigned int idx, size, width;
+
+  rtn = strdup("");
+  size = 1;
+  for  (idx = 0; idx < info->nitems; idx += 1) {
+    width = get_display_item(&result, info, &idx);
+    rtn = realloc(rtn, (size+width)*sizeof(char));
+    memcpy(rtn+size-1, result, width);
+    free(result);
     size += width;
   }
   rtn[size-1] = '\0';
@@ -1198,7 +1231,7 @@ static PLI_INT32 sys_display_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       vpiHandle callh, argv, scope;
       struct strobe_cb_info info;
       char* result;
-      unsigned int size, location=0;
+      unsigned int size;
       PLI_UINT32 fd_mcd;
 
       callh = vpi_handle(vpiSysTfCall, 0);
@@ -1247,15 +1280,7 @@ static PLI_INT32 sys_display_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 	/* Because %u and %z may put embedded NULL characters into the
 	 * returned string strlen() may not match the real size! */
       result = get_display(&size, &info);
-      while (location < size) {
-	    if (result[location] == '\0') {
-		  my_mcd_printf(fd_mcd, "%c", '\0');
-		  location += 1;
-	    } else {
-		  my_mcd_printf(fd_mcd, "%s", &result[location]);
-		  location += strlen(&result[location]);
-	    }
-      }
+      my_mcd_write(fd_mcd, result, size);
       if ((strncmp(name,"$display",8) == 0) ||
           (strncmp(name,"$fdisplay",9) == 0)) my_mcd_printf(fd_mcd, "\n");
 
@@ -1282,19 +1307,11 @@ static PLI_INT32 strobe_cb(p_cb_data cb)
       if ((! IS_MCD(info->fd_mcd) && vpi_get_file(info->fd_mcd) != NULL) ||
           ( IS_MCD(info->fd_mcd) && my_mcd_printf(info->fd_mcd, "") != EOF)) {
 	    char* result;
-	    unsigned int size, location=0;
+	    unsigned int size;
 	      /* Because %u and %z may put embedded NULL characters into the
 	       * returned string strlen() may not match the real size! */
 	    result = get_display(&size, info);
-	    while (location < size) {
-		  if (result[location] == '\0') {
-			my_mcd_printf(info->fd_mcd, "%c", '\0');
-			location += 1;
-		  } else {
-			my_mcd_printf(info->fd_mcd, "%s", &result[location]);
-			location += strlen(&result[location]);
-		  }
-	    }
+	    my_mcd_write(info->fd_mcd, result, size);
 	    my_mcd_printf(info->fd_mcd, "\n");
 	    free(result);
       }
@@ -1394,26 +1411,149 @@ static vpiHandle *monitor_callbacks = 0;
 static int monitor_scheduled = 0;
 static int monitor_enabled = 1;
 
+/*
+ * The monitor output is kept as a list of segments, one for each
+ * top level display item along with the items its format string
+ * consumes. The formatted text of a segment is only remade when one
+ * of its items changes, or every time if it uses an item that has no
+ * value change callback (e.g. $time). The last line written is also
+ * kept so that a line is only written when it really changes, or when
+ * monitor_force is set by $monitor/$monitoron.
+ */
+struct monitor_segment {
+      unsigned first, last;
+      int is_volatile;
+      int dirty;
+      char*text;
+      unsigned size;
+};
+
+static struct monitor_segment *monitor_segs = 0;
+static unsigned monitor_nsegs = 0;
+static unsigned *monitor_item_seg = 0;
+static int monitor_no_cache = 0;
+static int monitor_force = 0;
+static char *monitor_line = 0;
+static unsigned monitor_line_size = 0;
+
+static void monitor_cache_clear(void)
+{
+      unsigned idx;
+      for (idx = 0 ;  idx < monitor_nsegs ;  idx += 1)
+	    free(monitor_segs[idx].text);
+      free(monitor_segs);
+      monitor_segs = 0;
+      monitor_nsegs = 0;
+      free(monitor_item_seg);
+      monitor_item_seg = 0;
+      free(monitor_line);
+      monitor_line = 0;
+      monitor_line_size = 0;
+}
+
+static int monitor_item_is_volatile(unsigned idx)
+{
+      if (monitor_callbacks[idx]) return 0;
+
+      switch (vpi_get(vpiType, monitor_info.items[idx])) {
+	  case vpiConstant:
+	  case vpiParameter:
+	    return 0;
+	  default:
+	    return 1;
+      }
+}
+
+/*
+ * The first time the monitor is displayed, split the items into
+ * segments, formatting each segment as it is found.
+ */
+static void monitor_cache_build(void)
+{
+      unsigned idx, jdx;
+
+      monitor_item_seg = calloc(monitor_info.nitems, sizeof(unsigned));
+      for (idx = 0 ;  idx < monitor_info.nitems ;  idx += 1) {
+	    struct monitor_segment*seg;
+	    monitor_segs = realloc(monitor_segs, (monitor_nsegs+1) *
+	                           sizeof(struct monitor_segment));
+	    seg = monitor_segs + monitor_nsegs;
+	    seg->first = idx;
+	    seg->size = get_display_item(&seg->text, &monitor_info, &idx);
+	    seg->last = idx;
+	    seg->dirty = 0;
+	    seg->is_volatile = 0;
+	    for (jdx = seg->first ;  jdx <= seg->last ;  jdx += 1) {
+		  monitor_item_seg[jdx] = monitor_nsegs;
+		  if (monitor_item_is_volatile(jdx)) seg->is_volatile = 1;
+	    }
+	    monitor_nsegs += 1;
+      }
+}
+
+static char *monitor_cache_display(unsigned int *rtnsz)
+{
+      char *rtn;
+      unsigned idx, size;
+
+      if (monitor_segs == 0) {
+	    monitor_cache_build();
+      } else {
+	    for (idx = 0 ;  idx < monitor_nsegs ;  idx += 1) {
+		  struct monitor_segment*seg = monitor_segs + idx;
+		  unsigned item = seg->first;
+		  if (! (seg->dirty || seg->is_volatile)) continue;
+		  free(seg->text);
+		  seg->size = get_display_item(&seg->text, &monitor_info,
+		                               &item);
+		  assert(item == seg->last);
+		  seg->dirty = 0;
+	    }
+      }
+
+      size = 0;
+      for (idx = 0 ;  idx < monitor_nsegs ;  idx += 1)
+	    size += monitor_segs[idx].size;
+
+      rtn = malloc(size+1);
+      size = 0;
+      for (idx = 0 ;  idx < monitor_nsegs ;  idx += 1) {
+	    memcpy(rtn+size, monitor_segs[idx].text, monitor_segs[idx].size);
+	    size += monitor_segs[idx].size;
+      }
+      rtn[size] = 0;
+      *rtnsz = size;
+      return rtn;
+}
+
 static PLI_INT32 monitor_cb_2(p_cb_data cb)
 {
       char* result;
-      unsigned int size, location=0;
+      unsigned int size;
+
+      monitor_scheduled = 0;
 
 	/* Because %u and %z may put embedded NULL characters into the
 	 * returned string strlen() may not match the real size! */
-      result = get_display(&size, &monitor_info);
-      while (location < size) {
-	    if (result[location] == '\0') {
-		  my_mcd_printf(monitor_info.fd_mcd, "%c", '\0');
-		  location += 1;
-	    } else {
-		  my_mcd_printf(monitor_info.fd_mcd, "%s", &result[location]);
-		  location += strlen(&result[location]);
-	    }
+      if (monitor_no_cache)
+	    result = get_display(&size, &monitor_info);
+      else
+	    result = monitor_cache_display(&size);
+
+	/* Values may change and change back within a time step, so
+	   only write the line if it is different from the last one. */
+      if (!monitor_force && monitor_line && size == monitor_line_size
+          && memcmp(result, monitor_line, size) == 0) {
+	    free(result);
+	    return 0;
       }
+
+      my_mcd_write(monitor_info.fd_mcd, result, size);
       my_mcd_printf(monitor_info.fd_mcd, "\n");
-      monitor_scheduled = 0;
-      free(result);
+      monitor_force = 0;
+      free(monitor_line);
+      monitor_line = result;
+      monitor_line_size = size;
       return 0;
 }
 
@@ -1428,6 +1568,12 @@ static PLI_INT32 monitor_cb_1(p_cb_data cause)
       struct t_cb_data cb;
       struct t_vpi_time timerec;
 
+	/* Note which part of the monitor output is now stale. */
+      if (cause && monitor_item_seg) {
+	    unsigned idx = (vpiHandle*)cause->user_data - monitor_callbacks;
+	    monitor_segs[monitor_item_seg[idx]].dirty = 1;
+      }
+
       if (monitor_enabled == 0) return 0;
       if (monitor_scheduled) return 0;
 
@@ -1477,6 +1623,7 @@ static PLI_INT32 sys_monitor_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
 
 	    free(monitor_callbacks);
 	    monitor_callbacks = 0;
+	    monitor_cache_clear();
 
 	    free(monitor_info.filename);
 	    free(monitor_info.items);
@@ -1504,9 +1651,15 @@ static PLI_INT32 sys_monitor_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
       cb.cb_rtn = monitor_cb_1;
       cb.time = &timerec;
       cb.value = NULL;
+      monitor_no_cache = 0;
       for (idx = 0 ;  idx < monitor_info.nitems ;  idx += 1) {
 
 	    switch (vpi_get(vpiType, monitor_info.items[idx])) {
+		case vpiStringVar:
+		    /* A string variable is used as a format, so the
+		       items it consumes can change. Do not cache. */
+		  monitor_no_cache = 1;
+		  break;
 		case vpiMemoryWord:
 		  /*
 		   * We only support constant selections. Make this
@@ -1537,6 +1690,7 @@ static PLI_INT32 sys_monitor_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
 
 	/* When the $monitor is called, it schedules a first display
 	   for the end of the current time, like a $strobe. */
+      monitor_force = 1;
       monitor_cb_1(0);
 
       return 0;
@@ -1545,6 +1699,7 @@ static PLI_INT32 sys_monitor_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
 static PLI_INT32 sys_monitoron_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
 {
       monitor_enabled = 1;
+      monitor_force = 1;
       monitor_cb_1(0);
       return 0;
 }
@@ -1811,6 +1966,7 @@ static PLI_INT32 sys_timeformat_compiletf(ICARUS_VPI_CONST PLI_BYTE8*name)
 static PLI_INT32 sys_timeformat_calltf(ICARUS_VPI_CONST PLI_BYTE8*xx)
 {
       s_vpi_value value;
+      unsigned idx;
       vpiHandle sys   = vpi_handle(vpiSysTfCall, 0);
       vpiHandle argv  = vpi_iterate(vpiArgument, sys);
 
@@ -1843,6 +1999,11 @@ static PLI_INT32 sys_timeformat_calltf(ICARUS_VPI_CONST PLI_BYTE8*xx)
             sys_end_of_compile(NULL);
       }
 
+	/* Any %t text in the monitor cache has the old format, so
+	   remake every segment the next time the monitor runs. */
+      for (idx = 0 ;  idx < monitor_nsegs ;  idx += 1)
+	    monitor_segs[idx].dirty = 1;
+
       return 0;
 }
 
@@ -2051,6 +2212,7 @@ static PLI_INT32 sys_end_of_simulation(p_cb_data cb_data)
 {
       free(monitor_callbacks);
       monitor_callbacks = 0;
+      monitor_cache_clear();
       free(monitor_info.filename);
       free(monitor_info.items);
       monitor_info.items = 0;
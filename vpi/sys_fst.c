@@ -42,6 +42,12 @@ struct vcd_info {
       struct vcd_info *next;
       struct vcd_info *dmp_next;
       fstHandle handle;
+	/* The type of the item does not change, so it is saved here
+	   instead of being fetched for every change. */
+      PLI_INT32 type;
+	/* For plain vector signals the value is fetched as packed
+	   vpiVectorVal words of this size (in bits). */
+      int vec4_size;
       int scheduled;
 };
 
@@ -62,6 +68,9 @@ static enum lxm_optimum_mode_e {
       LXM_BOTH = 3
 } lxm_optimum_mode = LXM_NONE;
 
+  /* Compress and write the value change blocks in a separate thread. */
+static int fst_parallel = 0;
+
 static const char*units_names[] = {
       "s",
       "ms",
@@ -74,12 +83,17 @@ static const char*units_names[] = {
 static void show_this_item(struct vcd_info*info)
 {
       s_vpi_value value;
-      PLI_INT32 type = vpi_get(vpiType, info->item);
 
-      if (type == vpiRealVar) {
+      if (info->type == vpiRealVar) {
 	    value.format = vpiRealVal;
 	    vpi_get_value(info->item, &value);
 	    fstWriterEmitValueChange(dump_file, info->handle, &value.value.real);
+      } else if (info->vec4_size) {
+	    value.format = vpiVectorVal;
+	    vpi_get_value(info->item, &value);
+	    fstWriterEmitValueChangeVec4(dump_file, info->handle,
+	                                 info->vec4_size,
+	                                 (const uint32_t*)value.value.vector);
       } else {
 	    value.format = vpiBinStrVal;
 	    vpi_get_value(info->item, &value);
@@ -90,13 +104,11 @@ static void show_this_item(struct vcd_info*info)
 /* Dump values for a $dumpoff. */
 static void show_this_item_x(struct vcd_info*info)
 {
-      PLI_INT32 type = vpi_get(vpiType, info->item);
-
-      if (type == vpiRealVar) {
+      if (info->type == vpiRealVar) {
 	      /* Some tools dump nothing here...? */
             double mynan = strtod("NaN", NULL);
 	    fstWriterEmitValueChange(dump_file, info->handle, &mynan);
-      } else if (type == vpiNamedEvent) {
+      } else if (info->type == vpiNamedEvent) {
 	    /* Do nothing for named events. */
       } else {
 	    int siz = vpi_get(vpiSize, info->item);
@@ -403,6 +415,14 @@ static void open_dumpfile(vpiHandle callh)
 	        (lxm_optimum_mode == LXM_BOTH)) {
 		  fstWriterSetRepackOnClose(dump_file, 1);
 	    }
+	    if (fst_parallel) {
+#ifdef HAVE_LIBPTHREAD
+		  fstWriterSetParallelMode(dump_file, 1);
+#else
+		  vpi_printf("FST warning: -fst-parallel is not supported "
+		             "by this build, ignoring it.\n");
+#endif
+	    }
       }
 }
 
@@ -631,6 +651,23 @@ static void scan_item(unsigned depth, vpiHandle item, int skip)
 		  info->time.type = vpiSimTime;
 		  info->item  = item;
 		  info->handle = new_ident;
+		  info->type  = vpi_get(vpiType, item);
+		  switch (info->type) {
+		      case vpiNet:
+		      case vpiReg:
+		      case vpiIntegerVar:
+		      case vpiTimeVar:
+		      case vpiBitVar:
+		      case vpiByteVar:
+		      case vpiShortIntVar:
+		      case vpiIntVar:
+		      case vpiLongIntVar:
+			info->vec4_size = size;
+			break;
+		      default:
+			info->vec4_size = 0;
+			break;
+		  }
 		  info->scheduled = 0;
 
 		  cb.time      = &info->time;
@@ -901,6 +938,8 @@ void sys_fst_register()
 		  lxm_optimum_mode = LXM_BOTH;
 	    } else if (strcmp(vlog_info.argv[idx],"-fst-speed-space") == 0) {
 		  lxm_optimum_mode = LXM_BOTH;
+	    } else if (strcmp(vlog_info.argv[idx],"-fst-parallel") == 0) {
+		  fst_parallel = 1;
 	    }
       }
 
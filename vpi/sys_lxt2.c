@@ -50,6 +50,9 @@ struct vcd_info {
       vpiHandle cb;
       struct lxt2_wr_symbol *sym;
       struct vcd_info *dmp_next;
+	/* The type of the item does not change, so it is saved here
+	   instead of being fetched for every change. */
+      PLI_INT32 type;
 };
 
 struct vcd_info_chunk {
@@ -220,7 +223,7 @@ static void show_this_item(struct vcd_info*info)
 {
       s_vpi_value value;
 
-      if (vpi_get(vpiType, info->item) == vpiRealVar) {
+      if (info->type == vpiRealVar) {
 	    value.format = vpiRealVal;
 	    vpi_get_value(info->item, &value);
 	    vcd_work_emit_double(info->sym, value.value.real);
@@ -235,7 +238,7 @@ static void show_this_item(struct vcd_info*info)
 
 static void show_this_item_x(struct vcd_info*info)
 {
-      if (vpi_get(vpiType,info->item) == vpiRealVar) {
+      if (info->type == vpiRealVar) {
 	      /* Should write a NaN here? */
       } else {
 	    vcd_work_emit_bits(info->sym, "x");
@@ -640,6 +643,7 @@ static void scan_item(unsigned depth, vpiHandle item, int skip)
 		  info = new_vcd_info();
 
 		  info->item  = item;
+		  info->type  = vpi_get(vpiType, item);
 		  info->sym   = lxt2_wr_symbol_add(dump_file, ident,
 		                                   0 /* array rows */,
 		                                   vpi_get(vpiLeftRange, item),
@@ -677,6 +681,7 @@ static void scan_item(unsigned depth, vpiHandle item, int skip)
 	    info = new_vcd_info();
 
 	    info->item = item;
+	    info->type = vpi_get(vpiType, item);
 	    info->sym  = lxt2_wr_symbol_add(dump_file, ident,
 	                                    0 /* array rows */,
 	                                    vpi_get(vpiSize, item)-1,
@@ -37,8 +37,82 @@ static vpiHandle sdf_callh = 0;
   /* The cell in process. */
 static vpiHandle sdf_cur_cell;
 
+/*
+ * The module paths of the cell in process. These are collected the
+ * first time an IOPATH is annotated in the cell, so that matching
+ * further IOPATHs of the same cell does not need to go through the
+ * VPI to get the ports of every module path again.
+ */
+struct sdf_modpath_s {
+      vpiHandle path;
+      char*src;
+      char*dst;
+      int edge;
+};
+static struct sdf_modpath_s*sdf_cur_paths = 0;
+static unsigned sdf_cur_npaths = 0;
+static int sdf_cur_paths_valid = 0;
+
+static void clear_cell_paths(void)
+{
+      unsigned idx;
+      for (idx = 0 ;  idx < sdf_cur_npaths ;  idx += 1) {
+	    free(sdf_cur_paths[idx].src);
+	    free(sdf_cur_paths[idx].dst);
+      }
+      free(sdf_cur_paths);
+      sdf_cur_paths = 0;
+      sdf_cur_npaths = 0;
+      sdf_cur_paths_valid = 0;
+}
+
+static void load_cell_paths(void)
+{
+      vpiHandle iter, path;
+
+      assert(sdf_cur_paths_valid == 0);
+      sdf_cur_paths_valid = 1;
+
+      iter = vpi_iterate(vpiModPath, sdf_cur_cell);
+      if (iter) while ( (path = vpi_scan(iter)) ) {
+	    struct sdf_modpath_s*cur;
+
+	    vpiHandle path_t_in = vpi_handle(vpiModPathIn,path);
+	    vpiHandle path_t_out = vpi_handle(vpiModPathOut,path);
+
+	    vpiHandle path_in = vpi_handle(vpiExpr,path_t_in);
+	    vpiHandle path_out = vpi_handle(vpiExpr,path_t_out);
+
+	      /* The expressions for the path terms must be signals,
+	         vpiNet or vpiReg. */
+	    assert(vpi_get(vpiType,path_in) == vpiNet);
+	    assert(vpi_get(vpiType,path_out) == vpiNet
+		   || vpi_get(vpiType,path_out) == vpiReg);
+
+	    sdf_cur_paths = realloc(sdf_cur_paths, (sdf_cur_npaths+1) *
+	                                           sizeof(struct sdf_modpath_s));
+	    cur = sdf_cur_paths + sdf_cur_npaths;
+	    sdf_cur_npaths += 1;
+
+	    cur->path = path;
+	    cur->src = strdup(vpi_get_str(vpiName,path_in));
+	    cur->dst = strdup(vpi_get_str(vpiName,path_out));
+	    cur->edge = vpi_get(vpiEdge,path_t_in);
+      }
+}
+
 static vpiHandle find_scope(vpiHandle scope, const char*name)
 {
+	/* Try a direct lookup of the name first. This uses the name
+	 * index of the scope, which is much faster than scanning all
+	 * the child modules of a big design. */
+      if (vpi_get(vpiType, scope) == vpiModule) {
+	    vpiHandle cur = vpi_handle_by_name(name, scope);
+	    if (cur && cur != scope && vpi_get(vpiType, cur) == vpiModule &&
+	        strcmp(name, vpi_get_str(vpiName,cur)) == 0)
+		  return cur;
+      }
+
       vpiHandle idx = vpi_iterate(vpiModule, scope);
 	/* If this scope has no modules then it can't have the one we
 	 * are looking for so just return 0. */
@@ -65,6 +139,10 @@ void sdf_select_instance(const char*celltype, const char*cellinst)
 {
       char buffer[128];
 
+	/* A new cell is being selected, so forget the module paths of
+	   the previous cell. */
+      clear_cell_paths();
+
 	/* First follow the hierarchical parts of the cellinst name to
 	   get to the cell that I'm looking for. */
       vpiHandle scope = sdf_scope;
@@ -138,46 +216,36 @@ static const char*edge_str(int vpi_edge)
 void sdf_iopath_delays(int vpi_edge, const char*src, const char*dst,
 		       const struct sdf_delval_list_s*delval_list)
 {
-      vpiHandle iter, path;
+      unsigned pdx;
       int match_count = 0;
 
       if (sdf_cur_cell == 0)
 	    return;
 
-      iter = vpi_iterate(vpiModPath, sdf_cur_cell);
+      if (! sdf_cur_paths_valid)
+	    load_cell_paths();
 
 	/* Search for the modpath that matches the IOPATH by looking
 	   for the modpath that uses the same ports as the ports that
 	   the parser has found. */
-      if (iter) while ( (path = vpi_scan(iter)) ) {
+      for (pdx = 0 ;  pdx < sdf_cur_npaths ;  pdx += 1) {
+	    struct sdf_modpath_s*cur = sdf_cur_paths + pdx;
 	    s_vpi_delay delays;
 	    struct t_vpi_time delay_vals[12];
 	    int idx;
 
-	    vpiHandle path_t_in = vpi_handle(vpiModPathIn,path);
-	    vpiHandle path_t_out = vpi_handle(vpiModPathOut,path);
-
-	    vpiHandle path_in = vpi_handle(vpiExpr,path_t_in);
-	    vpiHandle path_out = vpi_handle(vpiExpr,path_t_out);
-
-	      /* The expressions for the path terms must be signals,
-	         vpiNet or vpiReg. */
-	    assert(vpi_get(vpiType,path_in) == vpiNet);
-	    assert(vpi_get(vpiType,path_out) == vpiNet
-		   || vpi_get(vpiType,path_out) == vpiReg);
-
 	      /* If the src name doesn't match, go on. */
-	    if (strcmp(src,vpi_get_str(vpiName,path_in)) != 0)
+	    if (strcmp(src,cur->src) != 0)
 		  continue;
 	      /* The edge type must match too. But note that if this
 	         IOPATH has no edge, then it matches with all edges of
 	         the modpath object. */
 /* --> Is this correct in the context of the 10, 01, etc. edges? */
-	    if (vpi_edge != vpiNoEdge && vpi_get(vpiEdge,path_t_in) != vpi_edge)
+	    if (vpi_edge != vpiNoEdge && cur->edge != vpi_edge)
 		  continue;
 
 	      /* If the dst name doesn't match, go on. */
-	    if (strcmp(dst,vpi_get_str(vpiName,path_out)) != 0)
+	    if (strcmp(dst,cur->dst) != 0)
 		  continue;
 
 	      /* Ah, this must be a match! */
@@ -187,7 +255,7 @@ void sdf_iopath_delays(int vpi_edge, const char*src, const char*dst,
 	    delays.mtm_flag = 0;
 	    delays.append_flag = 0;
 	    delays.plusere_flag = 0;
-	    vpi_get_delays(path, &delays);
+	    vpi_get_delays(cur->path, &delays);
 
 	    for (idx = 0 ; idx < delval_list->count ; idx += 1) {
 		  delay_vals[idx].type = vpiScaledRealTime;
@@ -196,7 +264,7 @@ void sdf_iopath_delays(int vpi_edge, const char*src, const char*dst,
 		  }
 	    }
 
-	    vpi_put_delays(path, &delays);
+	    vpi_put_delays(cur->path, &delays);
 	    match_count += 1;
       }
 
@@ -312,6 +380,7 @@ static PLI_INT32 sys_sdf_annotate_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
       sdf_callh = callh;
       sdf_process_file(sdf_fd, fname);
       sdf_callh = 0;
+      clear_cell_paths();
 
       fclose(sdf_fd);
       free(fname);
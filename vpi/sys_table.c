@@ -97,6 +97,8 @@ static void sys_lxt_or_vcd_register()
 		  dumper = "fst";
 	    } else if (strcmp(vlog_info.argv[idx],"-fst-speed-space") == 0) {
 		  dumper = "fst";
+	    } else if (strcmp(vlog_info.argv[idx],"-fst-parallel") == 0) {
+		  dumper = "fst";
 
 	    } else if (strcmp(vlog_info.argv[idx],"-fst-none") == 0) {
 		  dumper = "none";
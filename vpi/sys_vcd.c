@@ -39,6 +39,10 @@ struct vcd_info {
       vpiHandle cb;
       struct t_vpi_time time;
       const char *ident;
+	/* The type and size of the item do not change, so they are
+	   saved here instead of being fetched for every change. */
+      PLI_INT32 type;
+      PLI_INT32 size;
       struct vcd_info *next;
       struct vcd_info *dmp_next;
       int scheduled;
@@ -102,15 +106,14 @@ static char *truncate_bitvec(char *s)
 static void show_this_item(struct vcd_info*info)
 {
       s_vpi_value value;
-      PLI_INT32 type = vpi_get(vpiType, info->item);
 
-      if (type == vpiRealVar) {
+      if (info->type == vpiRealVar) {
 	    value.format = vpiRealVal;
 	    vpi_get_value(info->item, &value);
 	    fprintf(dump_file, "r%.16g %s\n", value.value.real, info->ident);
-      } else if (type == vpiNamedEvent) {
+      } else if (info->type == vpiNamedEvent) {
 	    fprintf(dump_file, "1%s\n", info->ident);
-      } else if (vpi_get(vpiSize, info->item) == 1) {
+      } else if (info->size == 1) {
 	    value.format = vpiBinStrVal;
 	    vpi_get_value(info->item, &value);
 	    fprintf(dump_file, "%s%s\n", value.value.str, info->ident);
@@ -125,14 +128,12 @@ static void show_this_item(struct vcd_info*info)
 /* Dump values for a $dumpoff. */
 static void show_this_item_x(struct vcd_info*info)
 {
-      PLI_INT32 type = vpi_get(vpiType, info->item);
-
-      if (type == vpiRealVar) {
+      if (info->type == vpiRealVar) {
 	      /* Some tools dump nothing here...? */
 	    fprintf(dump_file, "rNaN %s\n", info->ident);
-      } else if (type == vpiNamedEvent) {
+      } else if (info->type == vpiNamedEvent) {
 	    /* Do nothing for named events. */
-      } else if (vpi_get(vpiSize, info->item) == 1) {
+      } else if (info->size == 1) {
 	    fprintf(dump_file, "x%s\n", info->ident);
       } else {
 	    fprintf(dump_file, "bx %s\n", info->ident);
@@ -632,6 +633,8 @@ static void scan_item(unsigned depth, vpiHandle item, int skip)
 		  info->time.type = vpiSimTime;
 		  info->item  = item;
 		  info->ident = ident;
+		  info->type  = vpi_get(vpiType, item);
+		  info->size  = vpi_get(vpiSize, item);
 		  info->scheduled = 0;
 
 		  cb.time      = &info->time;
@@ -384,18 +384,32 @@ vvp_arith_mult::~vvp_arith_mult()
 
 void vvp_arith_mult::wide_(vvp_net_ptr_t ptr)
 {
-      vvp_vector2_t a2 (op_a_);
-      vvp_vector2_t b2 (op_b_);
-
-      if (a2.is_NaN() || b2.is_NaN()) {
+      const unsigned bits_per_word = 8 * sizeof(unsigned long);
+
+	// The operands are multiplied as word arrays. If either
+	// operand has X or Z bits, then the result is all X.
+      unsigned long*ap = op_a_.subarray(0, op_a_.size());
+      unsigned long*bp = ap? op_b_.subarray(0, op_b_.size()) : 0;
+      if (ap == 0 || bp == 0) {
+	    delete[]ap;
 	    ptr.ptr()->send_vec4(x_val_, 0);
 	    return;
       }
 
-      vvp_vector2_t result = a2 * b2;
+      unsigned awords = (op_a_.size() + bits_per_word - 1) / bits_per_word;
+      unsigned bwords = (op_b_.size() + bits_per_word - 1) / bits_per_word;
+      unsigned rwords = (wid_ + bits_per_word - 1) / bits_per_word;
 
-      vvp_vector4_t res4 = vector2_to_vector4(result, wid_);
+      unsigned long*rp = new unsigned long[rwords];
+      multiply_words(rp, rwords, ap, awords, bp, bwords);
+
+      vvp_vector4_t res4 (wid_);
+      res4.setarray(0, wid_, rp);
       ptr.ptr()->send_vec4(res4, 0);
+
+      delete[]ap;
+      delete[]bp;
+      delete[]rp;
 }
 
 void vvp_arith_mult::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
@@ -96,6 +96,74 @@ vvp_code_t codespace_null(void)
       return first_chunk + 0;
 }
 
+/*
+ * Follow a jump from the instruction cp to the target. If the target
+ * is an unconditional %jmp, or a conditional jump that tests the same
+ * bit in the same way as cp, then the jump would be taken again right
+ * away, so skip to its destination. Chunk links are skipped too. The
+ * hop limit stops this on loops like "T: %jmp T;".
+ */
+static vvp_code_t jump_destination(vvp_code_t cp, vvp_code_t target)
+{
+      for (unsigned hops = 0 ;  hops < 64 ;  hops += 1) {
+	    if (target->opcode == &of_CHUNK_LINK && target->cptr) {
+		  target = target->cptr;
+		  continue;
+	    }
+	    if (target->opcode == &of_JMP && target->cptr != target) {
+		  target = target->cptr;
+		  continue;
+	    }
+	    if (cp->opcode != &of_JMP && target->opcode == cp->opcode
+		&& target->bit_idx[0] == cp->bit_idx[0]
+		&& target->cptr != target) {
+		  target = target->cptr;
+		  continue;
+	    }
+	    break;
+      }
+
+      return target;
+}
+
+/*
+ * This is called once all the code labels are resolved. It threads
+ * jumps through jump chains, such as the ones the code generator
+ * makes for nested if/else and case statements, so that the thread
+ * goes straight to the final destination. It returns the number of
+ * jumps that were changed.
+ */
+unsigned codespace_thread_jumps(void)
+{
+      unsigned count = 0;
+
+      for (vvp_code_t chunk = first_chunk ; chunk ; ) {
+	    unsigned use = (chunk == current_chunk)
+		  ? current_within_chunk : code_chunk_size-1;
+
+	    for (unsigned idx = 0 ;  idx < use ;  idx += 1) {
+		  vvp_code_t cp = chunk + idx;
+		  if (cp->opcode != &of_JMP && cp->opcode != &of_JMP0 &&
+		      cp->opcode != &of_JMP0XZ && cp->opcode != &of_JMP1)
+			continue;
+		  if (cp->cptr == 0)
+			continue;
+
+		  vvp_code_t target = jump_destination(cp, cp->cptr);
+		  if (target != cp->cptr) {
+			cp->cptr = target;
+			count += 1;
+		  }
+	    }
+
+	    if (chunk == current_chunk)
+		  break;
+	    chunk = chunk[code_chunk_size-1].cptr;
+      }
+
+      return count;
+}
+
 #ifdef CHECK_WITH_VALGRIND
 void codespace_delete(void)
 {
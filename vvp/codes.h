@@ -242,6 +242,7 @@ struct vvp_code_s {
 	    vvp_net_t   *net2;
 	    vvp_code_t   cptr2;
 	    class ufunc_core*ufunc_core_ptr;
+	    struct waitable_hooks_s*waitable;
       };
 };
 
@@ -263,4 +264,11 @@ extern vvp_code_t codespace_allocate(void);
 extern vvp_code_t codespace_next(void);
 extern vvp_code_t codespace_null(void);
 
+/*
+ * Once all the code labels are resolved, this retargets jumps that
+ * land on other jumps so that they go directly to the final
+ * destination. It returns the number of jumps changed.
+ */
+extern unsigned codespace_thread_jumps(void);
+
 #endif
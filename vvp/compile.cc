@@ -725,6 +725,12 @@ void compile_cleanup(void)
 
       compile_errors += nerrs;
 
+      unsigned threaded = codespace_thread_jumps();
+      if (verbose_flag) {
+	    fprintf(stderr, " ... Threaded %u jumps\n", threaded);
+	    fflush(stderr);
+      }
+
       if (verbose_flag) {
 	    fprintf(stderr, " ... Removing symbol tables\n");
 	    fflush(stderr);
@@ -536,6 +536,8 @@ int main(int argc, char*argv[])
 			   count_assign_arword_pool());
 	    vpi_mcd_printf(1, "    %8lu other events (pool=%lu)\n",
 			   count_gen_events, count_gen_pool());
+	    vpi_mcd_printf(1, "    %8lu thread objects in pool\n",
+			   count_vthread_pool());
       }
 
       final_cleanup();
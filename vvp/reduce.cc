@@ -100,12 +100,7 @@ vvp_reduce_and::~vvp_reduce_and()
 
 vvp_bit4_t vvp_reduce_and::calculate_result() const
 {
-      vvp_bit4_t res =  BIT4_1;
-
-      for (unsigned idx = 0 ;  idx < bits_.size() ;  idx += 1)
-	    res = res & bits_.value(idx);
-
-      return res;
+      return bits_.reduce_and();
 }
 
 class vvp_reduce_or  : public vvp_reduce_base {
@@ -126,12 +121,7 @@ vvp_reduce_or::~vvp_reduce_or()
 
 vvp_bit4_t vvp_reduce_or::calculate_result() const
 {
-      vvp_bit4_t res =  BIT4_0;
-
-      for (unsigned idx = 0 ;  idx < bits_.size() ;  idx += 1)
-	    res = res | bits_.value(idx);
-
-      return res;
+      return bits_.reduce_or();
 }
 
 class vvp_reduce_xor  : public vvp_reduce_base {
@@ -152,12 +142,7 @@ vvp_reduce_xor::~vvp_reduce_xor()
 
 vvp_bit4_t vvp_reduce_xor::calculate_result() const
 {
-      vvp_bit4_t res =  BIT4_0;
-
-      for (unsigned idx = 0 ;  idx < bits_.size() ;  idx += 1)
-	    res = res ^ bits_.value(idx);
-
-      return res;
+      return bits_.reduce_xor();
 }
 
 class vvp_reduce_nand  : public vvp_reduce_base {
@@ -178,12 +163,7 @@ vvp_reduce_nand::~vvp_reduce_nand()
 
 vvp_bit4_t vvp_reduce_nand::calculate_result() const
 {
-      vvp_bit4_t res =  BIT4_1;
-
-      for (unsigned idx = 0 ;  idx < bits_.size() ;  idx += 1)
-	    res = res & bits_.value(idx);
-
-      return ~res;
+      return ~bits_.reduce_and();
 }
 
 class vvp_reduce_nor  : public vvp_reduce_base {
@@ -204,12 +184,7 @@ vvp_reduce_nor::~vvp_reduce_nor()
 
 vvp_bit4_t vvp_reduce_nor::calculate_result() const
 {
-      vvp_bit4_t res =  BIT4_0;
-
-      for (unsigned idx = 0 ;  idx < bits_.size() ;  idx += 1)
-	    res = res | bits_.value(idx);
-
-      return ~res;
+      return ~bits_.reduce_or();
 }
 
 class vvp_reduce_xnor  : public vvp_reduce_base {
@@ -230,12 +205,7 @@ vvp_reduce_xnor::~vvp_reduce_xnor()
 
 vvp_bit4_t vvp_reduce_xnor::calculate_result() const
 {
-      vvp_bit4_t res =  BIT4_0;
-
-      for (unsigned idx = 0 ;  idx < bits_.size() ;  idx += 1)
-	    res = res ^ bits_.value(idx);
-
-      return ~res;
+      return ~bits_.reduce_xor();
 }
 
 static void make_reduce(char*label, vvp_net_fun_t*red, struct symb_s arg)
@@ -760,6 +760,14 @@ void schedule_vthread(vthread_t thr, vvp_time64_t delay, bool push_flag)
       }
 }
 
+void schedule_vthread_list(vthread_t thr)
+{
+      struct vthread_event_s*cur = new vthread_event_s;
+
+      cur->thr = thr;
+      schedule_event_(cur, 0, SEQ_ACTIVE);
+}
+
 void schedule_final_vthread(vthread_t thr)
 {
       struct vthread_event_s*cur = new vthread_event_s;
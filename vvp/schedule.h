@@ -35,6 +35,14 @@
 extern void schedule_vthread(vthread_t thr, vvp_time64_t delay,
 			     bool push_flag =false);
 
+/*
+ * This schedules a list of threads, linked through their wait_next
+ * pointers, to run with delay 0. The whole list is one event, and the
+ * caller has already marked the threads scheduled. Events use this
+ * to wake all their waiting threads at once.
+ */
+extern void schedule_vthread_list(vthread_t thr);
+
 extern void schedule_final_vthread(vthread_t thr);
 
 /*
@@ -58,6 +58,8 @@ extern unsigned long count_assign_arword_pool(void);
 extern unsigned long count_gen_events;
 extern unsigned long count_gen_pool(void);
 
+extern unsigned long count_vthread_pool(void);
+
 extern size_t size_opcodes;
 extern size_t size_vvp_nets;
 extern size_t size_vvp_net_funs;
@@ -21,10 +21,10 @@
 # include  "compile.h"
 # include  "symbols.h"
 # include  "codes.h"
+# include  "schedule.h"
 # include  "ufunc.h"
 # include  "vvp_net_sig.h"
 # include  "vthread.h"
-# include  "schedule.h"
 #ifdef CHECK_WITH_VALGRIND
 # include  "vvp_cleanup.h"
 #endif
@@ -48,6 +48,7 @@ ufunc_core::ufunc_core(unsigned owid, vvp_net_t*ptr,
       ports_ = ports;
       code_ = sa;
       thread_ = 0;
+      call_pending_ = false;
       call_scope_ = call_scope__;
 
       functor_ref_lookup(&result_, result_label);
@@ -60,11 +61,13 @@ ufunc_core::ufunc_core(unsigned owid, vvp_net_t*ptr,
 
 ufunc_core::~ufunc_core()
 {
+      if (thread_)
+	    vthread_delete(thread_);
       delete [] ports_;
 }
 
 /*
- * This method is called by the %exec_ufunc function to prepare the
+ * This method is called by vthread_call_ufunc to prepare the
  * input variables of the function for execution. The method copies
  * the input values collected by the core to the variables.
  */
@@ -100,13 +103,13 @@ void ufunc_core::assign_bits_to_ports(vvp_context_t context)
 }
 
 /*
- * This method is called by the %exec_ufunc instruction to copy the
- * result from the return code variable and deliver it to the output
- * of the functor, back into the netlist.
+ * This method is called by vthread_call_ufunc to copy the result from
+ * the return code variable and deliver it to the output of the
+ * functor, back into the netlist.
  */
 void ufunc_core::finish_thread()
 {
-      thread_ = 0;
+      call_pending_ = false;
       if (vvp_fun_signal_real*sig = dynamic_cast<vvp_fun_signal_real*>(result_->fun))
 	    propagate_real(sig->real_unfiltered_value());
 
@@ -141,12 +144,17 @@ void ufunc_core::recv_real_from_inputs(unsigned)
 
 void ufunc_core::invoke_thread_()
 {
-      if (thread_ == 0) {
-	    thread_ = vthread_new(code_, call_scope_);
-	    schedule_vthread(thread_, 0);
+      if (! call_pending_) {
+	    call_pending_ = true;
+	    schedule_generic(this, 0, false);
       }
 }
 
+void ufunc_core::run_run()
+{
+      vthread_call_ufunc(this);
+}
+
 /*
  * This function compiles the .ufunc statement that is discovered in
  * the source file. Create all the functors and the thread, and
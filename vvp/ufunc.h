@@ -44,10 +44,15 @@
  * of the netlist. This is where the result is delivered back to the
  * netlist.
  *
+ * When an input changes, the core schedules itself as an event. When
+ * that event runs, the core calls the function directly on a thread
+ * that it keeps and reuses for every call, so a call does not need to
+ * create or schedule a thread.
+ *
  * This class relies to the vvp_wide_fun_* classes in vvp_net.h.
  */
 
-class ufunc_core : public vvp_wide_fun_core {
+class ufunc_core : public vvp_wide_fun_core, private vvp_gen_event_s {
 
     public:
       ufunc_core(unsigned ow, vvp_net_t*ptr,
@@ -60,6 +65,11 @@ class ufunc_core : public vvp_wide_fun_core {
 
       struct __vpiScope*call_scope() { return call_scope_; }
       struct __vpiScope*func_scope() { return func_scope_; }
+	// The start of the function code.
+      vvp_code_t func_code() { return code_->cptr; }
+
+      vthread_t func_thread() { return thread_; }
+      void set_func_thread(vthread_t thr) { thread_ = thr; }
 
       void assign_bits_to_ports(vvp_context_t context);
       void finish_thread();
@@ -73,6 +83,8 @@ class ufunc_core : public vvp_wide_fun_core {
 
       void invoke_thread_(void);
 
+      void run_run();
+
 
     private:
 	// output width of the function node.
@@ -83,8 +95,10 @@ class ufunc_core : public vvp_wide_fun_core {
       vvp_net_t**ports_;
 
 	// This is a thread to execute the behavioral portion of the
-	// function.
+	// function. It is created by the first call and then reused.
       vthread_t thread_;
+	// True if a call is scheduled but has not yet finished.
+      bool call_pending_;
       struct __vpiScope*call_scope_;
       struct __vpiScope*func_scope_;
       vvp_code_t code_;
@@ -48,6 +48,7 @@ extern FILE* vpi_trace;
 typedef struct mcd_entry {
 	FILE *fp;
 	char *filename;
+	char *buffer;
 } mcd_entry_s;
 static mcd_entry_s mcd_table[31];
 static mcd_entry_s *fd_table = NULL;
@@ -55,6 +56,37 @@ static unsigned fd_table_len = 0;
 
 static FILE* logfile;
 
+/*
+ * If the VVP_FILE_BUFFER_SIZE environment variable is set, then files
+ * opened by $fopen get a stdio buffer of that many bytes (a K or M
+ * suffix may be used) instead of the default. A large buffer makes
+ * writing big trace files with $fwrite/$fdisplay much cheaper since
+ * the data reaches the file in large blocks. $fflush can still be
+ * used to force the data out.
+ */
+static size_t file_buffer_size = 0;
+
+static void set_file_buffer(mcd_entry_s*entry)
+{
+      entry->buffer = NULL;
+      if (file_buffer_size == 0) return;
+
+      entry->buffer = (char *) malloc(file_buffer_size);
+      if (setvbuf(entry->fp, entry->buffer, _IOFBF, file_buffer_size)) {
+	    free(entry->buffer);
+	    entry->buffer = NULL;
+      }
+}
+
+static void close_entry(mcd_entry_s*entry)
+{
+      free(entry->filename);
+      free(entry->buffer);
+      entry->fp = NULL;
+      entry->filename = NULL;
+      entry->buffer = NULL;
+}
+
 /* Initialize mcd portion of vpi.  Must be called before
  * any vpi_mcd routines can be used.
  */
@@ -65,6 +97,25 @@ void vpip_mcd_init(FILE *log)
       for (unsigned idx = 0; idx < fd_table_len; idx += 1) {
 	    fd_table[idx].fp = NULL;
 	    fd_table[idx].filename = NULL;
+	    fd_table[idx].buffer = NULL;
+      }
+
+      if (const char*size = getenv("VVP_FILE_BUFFER_SIZE")) {
+	    char*eptr;
+	    unsigned long val = strtoul(size, &eptr, 10);
+	    if (*eptr == 'k' || *eptr == 'K') {
+		  val *= 1024;
+		  eptr += 1;
+	    } else if (*eptr == 'm' || *eptr == 'M') {
+		  val *= 1024*1024;
+		  eptr += 1;
+	    }
+	    if (*eptr != 0 || eptr == size) {
+		  fprintf(stderr, "Warning: Ignoring invalid "
+			  "VVP_FILE_BUFFER_SIZE (%s).\n", size);
+		  val = 0;
+	    }
+	    file_buffer_size = val;
       }
 
       mcd_table[0].fp = stdout;
@@ -116,9 +167,7 @@ extern "C" PLI_UINT32 vpi_mcd_close(PLI_UINT32 mcd)
 		for(int i = 1; i < 31; i++) {
 			if(((mcd>>i) & 1) && mcd_table[i].fp) {
 				if(fclose(mcd_table[i].fp)) rc |= 1<<i;
-				free(mcd_table[i].filename);
-				mcd_table[i].fp = NULL;
-				mcd_table[i].filename = NULL;
+				close_entry(&mcd_table[i]);
 			} else {
 				rc |= 1<<i;
 			}
@@ -127,9 +176,7 @@ extern "C" PLI_UINT32 vpi_mcd_close(PLI_UINT32 mcd)
 		unsigned idx = FD_IDX(mcd);
 		if (idx > 2 && idx < fd_table_len && fd_table[idx].fp) {
 			rc = fclose(fd_table[idx].fp);
-			free(fd_table[idx].filename);
-			fd_table[idx].fp = NULL;
-			fd_table[idx].filename = NULL;
+			close_entry(&fd_table[idx]);
 		}
 	}
 	return rc;
@@ -165,6 +212,7 @@ got_entry:
 	if(mcd_table[i].fp == NULL)
 		return 0;
 	mcd_table[i].filename = strdup(name);
+	set_file_buffer(&mcd_table[i]);
 
 	if (vpi_trace) {
 	      fprintf(vpi_trace, "vpi_mcd_open(%s) --> 0x%08x\n",
@@ -303,12 +351,14 @@ extern "C" PLI_INT32 vpi_fopen(const char*name, const char*mode)
       for (unsigned idx = i; idx < fd_table_len; idx += 1) {
 	    fd_table[idx].fp = NULL;
 	    fd_table[idx].filename = NULL;
+	    fd_table[idx].buffer = NULL;
       }
 
 got_entry:
       fd_table[i].fp = fopen(name, mode);
       if (fd_table[i].fp == NULL) return 0;
       fd_table[i].filename = strdup(name);
+      set_file_buffer(&fd_table[i]);
       return ((1U<<31)|i);
 }
 
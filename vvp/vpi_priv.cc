@@ -635,6 +635,11 @@ void vpip_vec4_get_value(const vvp_vector4_t&word_val, unsigned width,
 
 	  case vpiBinStrVal:
 	    rbuf = need_result_buf(width+1, RBUF_VAL);
+	    if (width == word_val.size()) {
+		  vpip_vec4_to_bin_str(word_val, rbuf, width+1);
+		  vp->value.str = rbuf;
+		  break;
+	    }
 	    for (unsigned idx = 0 ;  idx < width ;  idx += 1) {
 		  vvp_bit4_t bit = word_val.value(idx);
 		  rbuf[width-idx-1] = vvp_bit4_to_ascii(bit);
@@ -1221,43 +1226,70 @@ vpiHandle vpi_handle_by_index(vpiHandle ref, PLI_INT32 idx)
       return ref->vpi_index(idx);
 }
 
+/*
+ * Bring the name index of the scope up to date with the internal
+ * items of the scope. The index is created the first time a name is
+ * looked up in the scope, and only items added since then need to be
+ * indexed on later lookups. The standard says that since a port does
+ * not have a full name it cannot be found by name, so ports are not
+ * indexed. If there are duplicate names, the first item wins.
+ */
+static void update_name_index(struct __vpiScope*ref)
+{
+      if (ref->name_index == 0)
+	    ref->name_index = new std::map<std::string,vpiHandle>;
+
+      for (unsigned i = ref->name_index_cnt ;  i < ref->nintern ;  i += 1) {
+	    if (vpi_get(vpiType, ref->intern[i]) == vpiPort) continue;
+	    char *nm = vpi_get_str(vpiName, ref->intern[i]);
+	    ref->name_index->insert(std::make_pair(std::string(nm),
+						   ref->intern[i]));
+      }
+      ref->name_index_cnt = ref->nintern;
+}
+
+/*
+ * If the name has the form <base>[<index>] where <base> is a memory
+ * or net array of the scope, then return the addressed word.
+ */
+static vpiHandle find_array_word(const char *name, struct __vpiScope*ref)
+{
+      const char *bp = strchr(name, '[');
+      if (bp == 0 || bp == name) return 0;
+
+      char *ep;
+      long idx = strtol(bp+1, &ep, 10);
+      if (ep == bp+1 || ep[0] != ']' || ep[1] != 0) return 0;
+
+      std::map<std::string,vpiHandle>::const_iterator cur
+	    = ref->name_index->find(std::string(name, bp-name));
+      if (cur == ref->name_index->end()) return 0;
+
+      int type = vpi_get(vpiType, cur->second);
+      if (type != vpiMemory && type != vpiNetArray) return 0;
+
+      return vpi_handle_by_index(cur->second, idx);
+}
+
 static vpiHandle find_name(const char *name, vpiHandle handle)
 {
-      vpiHandle rtn = 0;
       struct __vpiScope*ref = dynamic_cast<__vpiScope*>(handle);
 
+      update_name_index(ref);
+
+      std::map<std::string,vpiHandle>::const_iterator cur
+	    = ref->name_index->find(name);
+      if (cur != ref->name_index->end())
+	    return cur->second;
+
+      if (vpiHandle word = find_array_word(name, ref))
+	    return word;
+
       /* check module names */
       if (!strcmp(name, vpi_get_str(vpiName, handle)))
-	    rtn = handle;
-
-      /* brute force search for the name in all objects in this scope */
-      for (unsigned i = 0 ;  i < ref->nintern ;  i += 1) {
-	      /* The standard says that since a port does not have a full
-	       * name it cannot be found by name. Because of this we need
-	       * to skip ports here so the correct handle can be located. */
-	    if (vpi_get(vpiType, ref->intern[i]) == vpiPort) continue;
-	    char *nm = vpi_get_str(vpiName, ref->intern[i]);
-	    if (!strcmp(name, nm)) {
-		  rtn = ref->intern[i];
-		  break;
-	    } else if (vpi_get(vpiType, ref->intern[i]) == vpiMemory ||
-	               vpi_get(vpiType, ref->intern[i]) == vpiNetArray) {
-		  /* We need to iterate on the words */
-		  vpiHandle word_i, word_h;
-		  word_i = vpi_iterate(vpiMemoryWord, ref->intern[i]);
-		  while (word_i && (word_h = vpi_scan(word_i))) {
-			nm = vpi_get_str(vpiName, word_h);
-			if (!strcmp(name, nm)) {
-			      rtn = word_h;
-			      break;
-			}
-		  }
-	    }
-	    /* found it yet? */
-	    if (rtn) break;
-      }
+	    return handle;
 
-      return rtn;
+      return 0;
 }
 
 static vpiHandle find_scope(const char *name, vpiHandle handle, int depth)
@@ -239,6 +239,11 @@ struct __vpiScope : public __vpiHandle {
 	/* Keep an array of internal scope items. */
       class __vpiHandle**intern;
       unsigned nintern;
+	/* Index of the internal items by name, used by
+	   vpi_handle_by_name. This is created when first needed, and
+	   covers the first name_index_cnt items of intern. */
+      std::map<std::string,vpiHandle>*name_index;
+      unsigned name_index_cnt;
 	/* Set of types */
       std::map<std::string,class_type*> classes;
         /* Keep an array of items to be automatically allocated */
@@ -756,12 +761,36 @@ extern unsigned vpip_vec4_to_dec_str(const vvp_vector4_t&vec4,
 				     int signed_flag);
 
 
+/*
+ * These make binary, hex and octal string versions of a vector. The
+ * vector is consumed a word at a time, and the hex/octal digits are
+ * looked up in the hex_digits/oct_digits tables.
+ */
+extern void vpip_vec4_to_bin_str(const vvp_vector4_t&bits, char*buf,
+				 unsigned nbuf);
+
 extern void vpip_vec4_to_hex_str(const vvp_vector4_t&bits, char*buf,
 				 unsigned nbuf);
 
 extern void vpip_vec4_to_oct_str(const vvp_vector4_t&bits, char*buf,
 				 unsigned nbuf);
 
+/*
+ * The hex_digits and oct_digits tables are indexed by 2 bits per
+ * vector bit (0, 1, 2 for X, 3 for Z) with the LSB of the digit in
+ * the low bits. This makes that index from (up to) the low 4 bits of
+ * the abits/bbits words of a vvp_vector4_t.
+ */
+static inline unsigned vpip_digit_index(unsigned long abits,
+					unsigned long bbits)
+{
+      static const unsigned char spread[16] = {
+	    0x00, 0x01, 0x04, 0x05, 0x10, 0x11, 0x14, 0x15,
+	    0x40, 0x41, 0x44, 0x45, 0x50, 0x51, 0x54, 0x55
+      };
+      return spread[(abits^bbits) & 0xf] | (spread[bbits & 0xf] << 1);
+}
+
 extern void vpip_bin_str_to_vec4(vvp_vector4_t&val, const char*buf);
 extern void vpip_oct_str_to_vec4(vvp_vector4_t&val, const char*str);
 extern void vpip_dec_str_to_vec4(vvp_vector4_t&val, const char*str);
@@ -118,6 +118,7 @@ static void delete_sub_scopes(struct __vpiScope *scope)
 	    }
       }
       free(scope->intern);
+      delete scope->name_index;
 
 	/* Clean up any class definitions. */
       map<std::string, class_type*>::iterator citer;
@@ -464,6 +465,8 @@ compile_scope_decl(char*label, char*type, char*name, char*tname,
       scope->is_automatic = is_automatic;
       scope->intern = 0;
       scope->nintern = 0;
+      scope->name_index = 0;
+      scope->name_index_cnt = 0;
       scope->item = 0;
       scope->nitem = 0;
       scope->live_contexts = 0;
@@ -140,19 +140,32 @@ static vpiHandle fill_in_net4(struct __vpiSignal*obj,
  * They work with full or partial signals.
  */
 
+/*
+ * The waveform dumpers get the value of every changed signal in this
+ * format, so get the whole vector at once instead of making a virtual
+ * value() call for each bit.
+ */
 static void format_vpiBinStrVal(vvp_signal_value*sig, int base, unsigned wid,
                                 s_vpi_value*vp)
 {
       char *rbuf = need_result_buf(wid+1, RBUF_VAL);
       long end = base + (signed)wid;
       long offset = end - 1;
-      long ssize = (signed)sig->value_size();
+      vvp_vector4_t tmp;
+      sig->vec4_value(tmp);
+      long ssize = (signed)tmp.size();
+
+      if (base == 0 && end == ssize) {
+	    vpip_vec4_to_bin_str(tmp, rbuf, wid+1);
+	    vp->value.str = rbuf;
+	    return;
+      }
 
       for (long idx = base ;  idx < end ;  idx += 1) {
 	    if (idx < 0 || idx >= ssize) {
                   rbuf[offset-idx] = 'x';
 	    } else {
-                  rbuf[offset-idx] = vvp_bit4_to_ascii(sig->value(idx));
+                  rbuf[offset-idx] = vvp_bit4_to_ascii(tmp.value(idx));
 	    }
       }
       rbuf[wid] = 0;
@@ -169,6 +182,18 @@ static void format_vpiOctStrVal(vvp_signal_value*sig, int base, unsigned wid,
       long ssize = (signed)sig->value_size();
       unsigned val = 0;
 
+	/* If the bits are all in the signal, then convert them
+	   from the vector a word at a time. */
+      if (base >= 0 && end <= ssize) {
+	    vvp_vector4_t tmp;
+	    sig->vec4_value(tmp);
+	    if (end < ssize || base > 0)
+		  tmp = tmp.subvalue(base, wid);
+	    vpip_vec4_to_oct_str(tmp, rbuf, dwid+1);
+	    vp->value.str = rbuf;
+	    return;
+      }
+
       rbuf[dwid] = 0;
       for (long idx = base ;  idx < end ;  idx += 1) {
 	    unsigned bit = 0;
@@ -225,6 +250,18 @@ static void format_vpiHexStrVal(vvp_signal_value*sig, int base, unsigned wid,
       long ssize = (signed)sig->value_size();
       unsigned val = 0;
 
+	/* If the bits are all in the signal, then convert them
+	   from the vector a word at a time. */
+      if (base >= 0 && end <= ssize) {
+	    vvp_vector4_t tmp;
+	    sig->vec4_value(tmp);
+	    if (end < ssize || base > 0)
+		  tmp = tmp.subvalue(base, wid);
+	    vpip_vec4_to_hex_str(tmp, rbuf, dwid+1);
+	    vp->value.str = rbuf;
+	    return;
+      }
+
       rbuf[dwid] = 0;
       for (long idx = base ;  idx < end ;  idx += 1) {
 	    unsigned bit = 0;
@@ -369,6 +406,33 @@ static void format_vpiStringVal(vvp_signal_value*sig, int base, unsigned wid,
       char *rbuf = need_result_buf(wid/8 + ((wid&7)!=0) + 1, RBUF_VAL);
       char *cp = rbuf;
 
+	/* If the bits are all in the signal, then pull each
+	   character out of the vector in one piece. */
+      long ssize = (signed)sig->value_size();
+      if (base >= 0 && base+(signed)wid <= ssize) {
+	    vvp_vector4_t vec;
+	    sig->vec4_value(vec);
+	    for (unsigned off = (wid+7) & ~7U ;  off > 0 ;  off -= 8) {
+		  unsigned trans = wid - (off-8);
+		  if (trans > 8) trans = 8;
+
+		  unsigned long abits, bbits;
+		  vec.subword4(base+off-8, trans, abits, bbits);
+		  char ch = abits & ~bbits;
+
+		  /* Skip leading nulls. */
+		  if (ch == 0 && cp == rbuf)
+			continue;
+
+		  /* Nulls in the middle get turned into spaces. */
+		  *cp++ = ch ? ch : ' ';
+	    }
+	    *cp++ = 0;
+
+	    vp->value.str = rbuf;
+	    return;
+      }
+
       char tmp = 0;
       for (long idx = base+(signed)wid-1; idx >= base; idx -= 1) {
 	    tmp <<= 1;
@@ -478,46 +542,53 @@ static void format_vpiVectorVal(vvp_signal_value*sig, int base, unsigned wid,
                                 s_vpi_value*vp)
 {
       long end = base + (signed)wid;
-      unsigned int obit = 0;
       unsigned hwid = (wid + 31)/32;
 
       s_vpi_vecval *op = (p_vpi_vecval)
                          need_result_buf(hwid * sizeof(s_vpi_vecval), RBUF_VAL);
       vp->value.vector = op;
 
-      op->aval = op->bval = 0;
-      for (long idx = base ;  idx < end ;  idx += 1) {
-	    if (base >= 0 && base < (signed)sig->value_size()) {
-		switch (sig->value(idx)) {
-		case BIT4_0:
-		  op->aval &= ~(1 << obit);
-		  op->bval &= ~(1 << obit);
-		  break;
-		case BIT4_1:
-		  op->aval |= (1 << obit);
-		  op->bval &= ~(1 << obit);
-		  break;
-		case BIT4_X:
-		  op->aval |= (1 << obit);
-		  op->bval |= (1 << obit);
-		  break;
-		case BIT4_Z:
-		  op->aval &= ~(1 << obit);
-		  op->bval |= (1 << obit);
-		  break;
-		}
+	/* Get the value once, then copy it out 32 bits at a time. The
+	   abits/bbits encoding of the vvp_vector4_t is the same as the
+	   aval/bval encoding of the s_vpi_vecval. */
+      vvp_vector4_t tmp;
+      sig->vec4_value(tmp);
+      bool base_ok = base >= 0 && base < (signed)tmp.size();
+
+      for (long idx = base ;  idx < end ;  idx += 32, op += 1) {
+	    unsigned trans = (end - idx) < 32? end - idx : 32;
+	    unsigned long abits, bbits;
+
+	    if (base_ok && (idx + trans) <= tmp.size()) {
+		  tmp.subword4(idx, trans, abits, bbits);
+
+	    } else if (base_ok) {
+		    /* This word runs off the end of the vector, and
+		       value() returns BIT4_X for those bits. */
+		  abits = bbits = 0;
+		  for (unsigned obit = 0 ;  obit < trans ;  obit += 1) {
+			switch (tmp.value(idx+obit)) {
+			    case BIT4_0:
+			      break;
+			    case BIT4_1:
+			      abits |= 1UL << obit;
+			      break;
+			    case BIT4_X:
+			      abits |= 1UL << obit;
+			      bbits |= 1UL << obit;
+			      break;
+			    case BIT4_Z:
+			      bbits |= 1UL << obit;
+			      break;
+			}
+		  }
+
 	    } else {  /* BIT4_X */
-		  op->aval |= (1 << obit);
-		  op->bval |= (1 << obit);
+		  abits = bbits = (trans < 32)? (1UL << trans) - 1 : 0xffffffffUL;
 	    }
 
-	    obit++;
-	    if (!(obit % 32)) {
-		  op += 1;
-		  if ((op - vp->value.vector) < (ptrdiff_t)hwid)
-			op->aval = op->bval = 0;
-		  obit = 0;
-	    }
+	    op->aval = abits;
+	    op->bval = bbits;
       }
 }
 
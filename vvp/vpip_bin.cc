@@ -110,3 +110,28 @@ void vpip_bin_str_to_vec4(vvp_vector4_t&vec4, const char*buf)
 	    else vec4.set_bit(jdx, pad);
       }
 }
+
+void vpip_vec4_to_bin_str(const vvp_vector4_t&bits, char*buf, unsigned nbuf)
+{
+      static const char bin_digits[4] = { '0', '1', 'z', 'x' };
+      unsigned wid = bits.size();
+      unsigned slen = wid;
+      assert(slen < nbuf);
+
+      buf[slen] = 0;
+
+      for (unsigned idx = 0 ;  idx < wid ;  idx += 32) {
+	    unsigned trans = wid - idx;
+	    if (trans > 32) trans = 32;
+
+	    unsigned long abits, bbits;
+	    bits.subword4(idx, trans, abits, bbits);
+
+	    for (unsigned bit = 0 ;  bit < trans ;  bit += 1) {
+		  slen -= 1;
+		  buf[slen] = bin_digits[((bbits&1) << 1) | (abits&1)];
+		  abits >>= 1;
+		  bbits >>= 1;
+	    }
+      }
+}
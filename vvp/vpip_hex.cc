@@ -140,53 +140,35 @@ void vpip_hex_str_to_vec4(vvp_vector4_t&val, const char*str)
 
 void vpip_vec4_to_hex_str(const vvp_vector4_t&bits, char*buf, unsigned nbuf)
 {
-      unsigned slen = (bits.size() + 3) / 4;
+      unsigned wid = bits.size();
+      unsigned slen = (wid + 3) / 4;
       assert(slen < nbuf);
 
       buf[slen] = 0;
 
-      unsigned val = 0;
-      for (unsigned idx = 0 ;  idx < bits.size() ;  idx += 1) {
-	    unsigned vs = (idx%4) * 2;
-
-	    switch (bits.value(idx)) {
-		case BIT4_0:
-		  break;
-		case BIT4_1:
-		  val |= 1 << vs;
-		  break;
-		case BIT4_X:
-		  val |= 2 << vs;
-		  break;
-		case BIT4_Z:
-		  val |= 3 << vs;
-	    }
+	/* Work through the vector 8 digits at a time. */
+      for (unsigned idx = 0 ;  idx < wid ;  idx += 32) {
+	    unsigned trans = wid - idx;
+	    if (trans > 32) trans = 32;
+
+	    unsigned long abits, bbits;
+	    bits.subword4(idx, trans, abits, bbits);
+
+	    for (unsigned dig = 0 ;  dig < trans ;  dig += 4) {
+		  unsigned val = vpip_digit_index(abits, bbits);
+		  abits >>= 4;
+		  bbits >>= 4;
+
+		    /* Fill in X or Z if they are the only thing in
+		       a partial (most significant) digit. */
+		  if (trans-dig < 4) {
+			unsigned mask = (1U << 2*(trans-dig)) - 1;
+			if (val == (0xaa & mask)) val = 170;
+			else if (val == mask) val = 255;
+		  }
 
-	    if (vs == 6) {
 		  slen -= 1;
 		  buf[slen] = hex_digits[val];
-		  val = 0;
 	    }
       }
-
-	/* Fill in X or Z if they are the only thing in the value. */
-      switch (bits.size() % 4) {
-	  case 1:
-	    if (val == 2) val = 170;
-	    else if (val == 3) val = 255;
-	    break;
-	  case 2:
-	    if (val == 10) val = 170;
-	    else if (val == 15) val = 255;
-	    break;
-	  case 3:
-	    if (val == 42) val = 170;
-	    else if (val == 63) val = 255;
-	    break;
-      }
-
-      if (slen > 0) {
-	    slen -= 1;
-	    buf[slen] = hex_digits[val];
-      }
 }
@@ -121,49 +121,35 @@ void vpip_oct_str_to_vec4(vvp_vector4_t&val, const char*str)
 
 void vpip_vec4_to_oct_str(const vvp_vector4_t&bits, char*buf, unsigned nbuf)
 {
-      unsigned slen = (bits.size() + 2) / 3;
+      unsigned wid = bits.size();
+      unsigned slen = (wid + 2) / 3;
       assert(slen < nbuf);
 
       buf[slen] = 0;
 
-      unsigned val = 0;
-      for (unsigned idx = 0 ;  idx < bits.size() ;  idx += 1) {
-	    unsigned vs = (idx%3) * 2;
-
-	    switch (bits.value(idx)) {
-		case BIT4_0:
-		  break;
-		case BIT4_1:
-		  val |= 1 << vs;
-		  break;
-		case BIT4_X:
-		  val |= 2 << vs;
-		  break;
-		case BIT4_Z:
-		  val |= 3 << vs;
-	    }
+	/* Work through the vector 10 digits at a time. */
+      for (unsigned idx = 0 ;  idx < wid ;  idx += 30) {
+	    unsigned trans = wid - idx;
+	    if (trans > 30) trans = 30;
+
+	    unsigned long abits, bbits;
+	    bits.subword4(idx, trans, abits, bbits);
+
+	    for (unsigned dig = 0 ;  dig < trans ;  dig += 3) {
+		  unsigned val = vpip_digit_index(abits&7, bbits&7);
+		  abits >>= 3;
+		  bbits >>= 3;
+
+		    /* Fill in X or Z if they are the only thing in
+		       a partial (most significant) digit. */
+		  if (trans-dig < 3) {
+			unsigned mask = (1U << 2*(trans-dig)) - 1;
+			if (val == (0x2a & mask)) val = 42;
+			else if (val == mask) val = 63;
+		  }
 
-	    if (vs == 4) {
 		  slen -= 1;
 		  buf[slen] = oct_digits[val];
-		  val = 0;
 	    }
       }
-
-	/* Fill in X or Z if they are the only thing in the value. */
-      switch (bits.size() % 3) {
-	  case 1:
-	    if (val == 2) val = 42;
-	    else if (val == 3) val = 63;
-	    break;
-	  case 2:
-	    if (val == 10) val = 42;
-	    else if (val == 15) val = 63;
-	    break;
-      }
-
-      if (slen > 0) {
-	    slen -= 1;
-	    buf[slen] = oct_digits[val];
-      }
 }
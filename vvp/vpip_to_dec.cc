@@ -67,20 +67,39 @@
  * propagated as a "carry" to the next array element, the result is again
  * less than or equal to 2^BBITS.  BBITS and BASE are configured above
  * to depend on the "unsigned long" length of the host, for efficiency.
+ *
+ * Only the first vused elements of valv can be non-zero, so only those
+ * are shifted. The number grows from the bottom as the bits are shifted
+ * in, so this halves the work for wide values.
  */
-static inline void shift_in(unsigned long *valv, unsigned int vlen, unsigned long val)
+static inline void shift_in(unsigned long *valv, unsigned int &vused,
+                            unsigned int vlen, unsigned long val)
 {
 	unsigned int i;
 	/* printf("shift in %u\n",val); */
-	for (i=0; i<vlen; i++) {
+	for (i=0; i<vused; i++) {
 		val=(valv[i]<<BBITS)+val;
 		valv[i]=val%BASE;
 		val=val/BASE;
 	}
+	while (val!=0 && vused<vlen) {
+		valv[vused++]=val%BASE;
+		val=val/BASE;
+	}
 	if (val!=0)
 	      fprintf(stderr,"internal error: carry out %lu in " __FILE__ "\n",val);
 }
 
+static inline unsigned count_bits(unsigned long mask)
+{
+	unsigned cnt = 0;
+	while (mask) {
+		mask &= mask-1;
+		cnt += 1;
+	}
+	return cnt;
+}
+
 /* Since BASE is a power of ten, conversion of each element of the
  * valv array to decimal is easy.  sprintf(buf,"%d",v) could be made
  * to work, I suppose, but for speed and control I prefer to write
@@ -152,37 +171,30 @@ unsigned vpip_vec4_to_dec_str(const vvp_vector4_t&vec4,
 	    if (valv) free(valv);
 	    valv = (unsigned long*) calloc(vlen+ALLOC_MARGIN, sizeof (*valv));
 	    vlen_alloc=vlen+ALLOC_MARGIN;
-      } else {
-	    memset(valv,0,vlen*sizeof(valv[0]));
       }
+      unsigned int vused = 0;
 
-      for (idx = 0; idx < mbits; idx += 1) {
-	      /* printf("%c ",bits[mbits-idx-1]); */
-	    switch (vec4.value(mbits-idx-1)) {
-		case BIT4_Z:
-		  count_z += 1;
-		  break;
-		case BIT4_X:
-		  count_x += 1;
-		  break;
-		case BIT4_1:
-		  if (! comp)
-			val += 1;
-		  break;
-		case BIT4_0:
-		  if (comp)
-			val += 1;
-		  break;
-	    }
+	/* Shift the value in BBITS at a time, starting with the most
+	   significant chunk. The chunks are aligned to the LSB, so
+	   the first chunk may be partial. */
+      unsigned nchunks = (mbits+BBITS-1)/BBITS;
+      for (idx = nchunks; idx > 0; idx -= 1) {
+	    unsigned base = (idx-1)*BBITS;
+	    unsigned trans = mbits-base < BBITS? mbits-base : BBITS;
+	    unsigned long mask = (1UL<<trans)-1;
+	    unsigned long abits, bbits;
+	    vec4.subword4(base, trans, abits, bbits);
 
-	    if ((mbits-idx-1)%BBITS==0) {
-		    /* make negative 2's complement, not 1's complement */
-		  if (comp && idx==mbits-1) ++val;
-		  shift_in(valv,vlen,val);
-		  val=0;
-	    } else {
-		  val=val+val;
+	    if (bbits) {
+		  count_x += count_bits(abits & bbits);
+		  count_z += count_bits(~abits & bbits);
 	    }
+
+	      /* X and Z bits do not contribute to the value. */
+	    val = comp? (~abits & ~bbits & mask) : (abits & ~bbits);
+	      /* make negative 2's complement, not 1's complement */
+	    if (comp && idx==1) ++val;
+	    shift_in(valv,vused,vlen,val);
       }
 
 	if (count_x == vec4.size()) {
@@ -205,7 +217,7 @@ unsigned vpip_vec4_to_dec_str(const vvp_vector4_t&vec4,
 		    nbuf--;
 		      /* printf("-"); */
 	      }
-	      for (i=vlen-1; i>=0; i--) {
+	      for (i=vused-1; i>=0; i--) {
 		    zero_suppress = write_digits(valv[i],
 						 &buf,&nbuf,zero_suppress);
 		      /* printf(",%.4u",valv[i]); */
@@ -31,6 +31,8 @@
 #ifdef CHECK_WITH_VALGRIND
 # include  "vvp_cleanup.h"
 #endif
+# include  "slab.h"
+# include  "statistics.h"
 # include  <set>
 # include  <typeinfo>
 # include  <vector>
@@ -66,18 +68,24 @@ using namespace std;
  * Children that are detached with %join/detach need to have a different
  * parent/child relationship since the parent can still effect them if
  * it uses the %disable/fork or %wait/fork opcodes. The i_am_detached
- * flag and detached_children set are used for this relationship.
+ * flag and detached_children list are used for this relationship.
  *
  * Children placed into a task or function scope are given special
  * treatment, which is required to make task/function calls that they
- * represent work correctly. These task/function children are copied
- * into a task_func_children set to mark them for this handling. %join
+ * represent work correctly. These task/function children are marked
+ * with the i_am_task_func flag, and the parent counts them in its
+ * task_func_count. %join
  * operations will guarantee that task/function threads are joined first,
  * before any non-task/function threads.
  *
  * It is a programming error for a thread that created threads to not
  * %join (or %join/detach) as many as it created before it %ends. The
- * children set will get messed up otherwise.
+ * children list will get messed up otherwise.
+ *
+ * The children and detached_children lists are intrusive: the links
+ * live in the child threads themselves. A thread is in at most one
+ * such list at a time, so a fork or join never needs to allocate
+ * memory to track the parent/child relationship.
  *
  * the i_am_joining flag is a clue to children that the parent is
  * blocked in a %join and may need to be scheduled. The %end
@@ -94,6 +102,25 @@ using namespace std;
  * to reap the child immediately.
  */
 
+struct vthread_s;
+
+class vthread_list_s {
+    public:
+      inline vthread_list_s() : head_(0), count_(0) { }
+
+      bool empty() const { return head_ == 0; }
+      size_t size() const { return count_; }
+      struct vthread_s* front() const { return head_; }
+
+      inline void insert(struct vthread_s*thr);
+	// Return the number of items removed (0 or 1).
+      inline size_t erase(struct vthread_s*thr);
+
+    private:
+      struct vthread_s*head_;
+      size_t count_;
+};
+
 struct vthread_s {
       vthread_s();
 
@@ -213,12 +240,19 @@ struct vthread_s {
       unsigned waiting_for_event :1;
       unsigned is_scheduled      :1;
       unsigned delay_delete      :1;
+      unsigned i_am_task_func    :1;
+	/* A .ufunc core owns me and reuses me for every call. */
+      unsigned i_am_reusable     :1;
 	/* This points to the children of the thread. */
-      set<struct vthread_s*>children;
+      vthread_list_s children;
 	/* This points to the detached children of the thread. */
-      set<struct vthread_s*>detached_children;
+      vthread_list_s detached_children;
 	/* No more than 1 of the children are tasks or functions. */
-      set<vthread_s*>task_func_children;
+      unsigned task_func_count;
+	/* These link me into my parent's children or detached_children. */
+      vthread_list_s*sib_list;
+      struct vthread_s*sib_next;
+      struct vthread_s*sib_prev;
 	/* This points to my parent, if I have one. */
       struct vthread_s*parent;
 	/* This points to the containing scope. */
@@ -238,6 +272,11 @@ struct vthread_s {
 	    assert(stack_str_.empty());
 	    assert(stack_obj_size_ == 0);
       }
+
+	/* Threads are created and destroyed at a high rate by
+	   %fork/%join, so allocate them from a slab. */
+      static void* operator new(size_t);
+      static void operator delete(void*);
 };
 
 inline vthread_s::vthread_s()
@@ -245,6 +284,52 @@ inline vthread_s::vthread_s()
       stack_obj_size_ = 0;
 }
 
+static const size_t VTHREAD_CHUNK_COUNT = 8192 / sizeof(struct vthread_s) + 1;
+static slab_t<sizeof(vthread_s),VTHREAD_CHUNK_COUNT> vthread_heap;
+
+inline void* vthread_s::operator new(size_t size)
+{
+      assert(size == sizeof(vthread_s));
+      return vthread_heap.alloc_slab();
+}
+
+void vthread_s::operator delete(void*dptr)
+{
+      vthread_heap.free_slab(dptr);
+}
+
+unsigned long count_vthread_pool(void) { return vthread_heap.pool; }
+
+inline void vthread_list_s::insert(struct vthread_s*thr)
+{
+      assert(thr->sib_list == 0);
+      thr->sib_list = this;
+      thr->sib_prev = 0;
+      thr->sib_next = head_;
+      if (head_) head_->sib_prev = thr;
+      head_ = thr;
+      count_ += 1;
+}
+
+inline size_t vthread_list_s::erase(struct vthread_s*thr)
+{
+      if (thr->sib_list != this)
+	    return 0;
+
+      if (thr->sib_prev)
+	    thr->sib_prev->sib_next = thr->sib_next;
+      else
+	    head_ = thr->sib_next;
+      if (thr->sib_next)
+	    thr->sib_next->sib_prev = thr->sib_prev;
+
+      thr->sib_list = 0;
+      thr->sib_next = 0;
+      thr->sib_prev = 0;
+      count_ -= 1;
+      return 1;
+}
+
 static bool test_joinable(vthread_t thr, vthread_t child);
 static void do_join(vthread_t thr, vthread_t child);
 
@@ -366,6 +451,31 @@ static unsigned long* vector_to_array(struct vthread_s*thr,
       return thr->bits4.subarray(addr, wid);
 }
 
+/*
+ * This is the single word version of vector_to_array. The arithmetic
+ * and compare opcodes use this when the operand fits in a CPU word
+ * so that the common integer cases need no temporary arrays. Return
+ * false if there are any X or Z bits in the value.
+ */
+static inline bool vector_to_word(struct vthread_s*thr, unsigned addr,
+				  unsigned wid, unsigned long&val)
+{
+      assert(wid <= CPU_WORD_BITS);
+
+      if (addr == 0) {
+	    val = 0;
+	    return true;
+      }
+      if (addr == 1) {
+	    val = (wid < CPU_WORD_BITS)? (1UL << wid) - 1UL : -1UL;
+	    return true;
+      }
+      if (addr < 4)
+	    return false;
+
+      return thr->bits4.subword(addr, wid, val);
+}
+
 /*
  * This function gets from the thread a vector of bits starting from
  * the addressed location and for the specified width.
@@ -553,7 +663,13 @@ vthread_t vthread_new(vvp_code_t pc, struct __vpiScope*scope)
       thr->is_scheduled  = 0;
       thr->i_have_ended  = 0;
       thr->delay_delete  = 0;
+      thr->i_am_task_func = 0;
+      thr->i_am_reusable = 0;
       thr->waiting_for_event = 0;
+      thr->task_func_count = 0;
+      thr->sib_list = 0;
+      thr->sib_next = 0;
+      thr->sib_prev = 0;
       thr->event  = 0;
       thr->ecount = 0;
 
@@ -610,25 +726,19 @@ void vthreads_delete(struct __vpiScope*scope)
  */
 static void vthread_reap(vthread_t thr)
 {
-      if (! thr->children.empty()) {
-	    for (set<vthread_t>::iterator cur = thr->children.begin()
-		       ; cur != thr->children.end() ; ++cur) {
-		  vthread_t child = *cur;
-		  assert(child);
-		  assert(child->parent == thr);
-		  child->parent = thr->parent;
-	    }
+      while (! thr->children.empty()) {
+	    vthread_t child = thr->children.front();
+	    assert(child->parent == thr);
+	    thr->children.erase(child);
+	    child->parent = thr->parent;
       }
-      if (! thr->detached_children.empty()) {
-	    for (set<vthread_t>::iterator cur = thr->detached_children.begin()
-		       ; cur != thr->detached_children.end() ; ++cur) {
-		  vthread_t child = *cur;
-		  assert(child);
-		  assert(child->parent == thr);
-		  assert(child->i_am_detached);
-		  child->parent = 0;
-		  child->i_am_detached = 0;
-	    }
+      while (! thr->detached_children.empty()) {
+	    vthread_t child = thr->detached_children.front();
+	    assert(child->parent == thr);
+	    assert(child->i_am_detached);
+	    thr->detached_children.erase(child);
+	    child->parent = 0;
+	    child->i_am_detached = 0;
       }
       if (thr->parent) {
 	      /* assert that the given element was removed. */
@@ -654,7 +764,10 @@ static void vthread_reap(vthread_t thr)
       if ((thr->is_scheduled == 0) && (thr->waiting_for_event == 0)) {
 	    assert(thr->children.empty());
 	    assert(thr->wait_next == 0);
-	    if (thr->delay_delete)
+	      /* A reusable thread belongs to its .ufunc core. */
+	    if (thr->i_am_reusable)
+		  ;
+	    else if (thr->delay_delete)
 		  schedule_del_thr(thr);
 	    else
 		  vthread_delete(thr);
@@ -729,16 +842,20 @@ bool of_CHUNK_LINK(vthread_t thr, vvp_code_t code)
 /*
  * This is called by an event functor to wake up all the threads on
  * its list. I in fact created that list in the %wait instruction, and
- * I also am certain that the waiting_for_event flag is set.
+ * I also am certain that the waiting_for_event flag is set. The
+ * threads are marked scheduled in the same pass, and the list goes
+ * into the queue as a single event.
  */
 void vthread_schedule_list(vthread_t thr)
 {
       for (vthread_t cur = thr ;  cur ;  cur = cur->wait_next) {
 	    assert(cur->waiting_for_event);
 	    cur->waiting_for_event = 0;
+	    assert(cur->is_scheduled == 0);
+	    cur->is_scheduled = 1;
       }
 
-      schedule_vthread(thr, 0);
+      schedule_vthread_list(thr);
 }
 
 vvp_context_t vthread_get_wt_context()
@@ -853,7 +970,7 @@ bool of_ANDI(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
-bool of_ADD(vthread_t thr, vvp_code_t cp)
+static bool of_ADD_wide(vthread_t thr, vvp_code_t cp)
 {
       assert(cp->bit_idx[0] >= 4);
 
@@ -887,6 +1004,37 @@ bool of_ADD(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
+static bool of_ADD_word(vthread_t thr, vvp_code_t cp)
+{
+      unsigned adra = cp->bit_idx[0];
+      unsigned adrb = cp->bit_idx[1];
+      unsigned wid = cp->number;
+
+      assert(adra >= 4);
+
+      unsigned long lv, rv;
+      if (vector_to_word(thr, adra, wid, lv)
+	  && vector_to_word(thr, adrb, wid, rv)) {
+	    lv += rv;
+	    thr->bits4.setarray(adra, wid, &lv);
+      } else {
+	    vvp_vector4_t tmp (wid, BIT4_X);
+	    thr->bits4.set_vec(adra, tmp);
+      }
+
+      return true;
+}
+
+bool of_ADD(vthread_t thr, vvp_code_t cp)
+{
+      if (cp->number <= CPU_WORD_BITS)
+	    cp->opcode = &of_ADD_word;
+      else
+	    cp->opcode = &of_ADD_wide;
+
+      return cp->opcode(thr, cp);
+}
+
 bool of_ADD_WR(vthread_t thr, vvp_code_t)
 {
       double r = thr->pop_real();
@@ -901,7 +1049,7 @@ bool of_ADD_WR(vthread_t thr, vvp_code_t)
  * immediate value can be up to 16 bits, which are then padded to the
  * width of the vector with zero.
  */
-bool of_ADDI(vthread_t thr, vvp_code_t cp)
+static bool of_ADDI_wide(vthread_t thr, vvp_code_t cp)
 {
 	// Collect arguments
       unsigned bit_addr       = cp->bit_idx[0];
@@ -942,6 +1090,36 @@ bool of_ADDI(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
+static bool of_ADDI_word(vthread_t thr, vvp_code_t cp)
+{
+      unsigned adra = cp->bit_idx[0];
+      unsigned long imm = cp->bit_idx[1];
+      unsigned wid = cp->number;
+
+      assert(adra >= 4);
+
+      unsigned long lv;
+      if (vector_to_word(thr, adra, wid, lv)) {
+	    lv += imm;
+	    thr->bits4.setarray(adra, wid, &lv);
+      } else {
+	    vvp_vector4_t tmp (wid, BIT4_X);
+	    thr->bits4.set_vec(adra, tmp);
+      }
+
+      return true;
+}
+
+bool of_ADDI(vthread_t thr, vvp_code_t cp)
+{
+      if (cp->number <= CPU_WORD_BITS)
+	    cp->opcode = &of_ADDI_word;
+      else
+	    cp->opcode = &of_ADDI_wide;
+
+      return cp->opcode(thr, cp);
+}
+
 /* %assign/ar <array>, <delay>
  * Generate an assignment event to a real array. Index register 3
  * contains the canonical address of the word in the memory. <delay>
@@ -1760,7 +1938,7 @@ static bool of_CMPIU_the_hard_way(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
-bool of_CMPIU(vthread_t thr, vvp_code_t cp)
+static bool of_CMPIU_wide(vthread_t thr, vvp_code_t cp)
 {
       unsigned addr = cp->bit_idx[0];
       unsigned long imm  = cp->bit_idx[1];
@@ -1794,6 +1972,31 @@ bool of_CMPIU(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
+static bool of_CMPIU_word(vthread_t thr, vvp_code_t cp)
+{
+      unsigned long imm = cp->bit_idx[1];
+      unsigned long lv;
+      if (! vector_to_word(thr, cp->bit_idx[0], cp->number, lv))
+	    return of_CMPIU_the_hard_way(thr, cp);
+
+      vvp_bit4_t eq = (lv == imm)? BIT4_1 : BIT4_0;
+      thr_put_bit(thr, 4, eq);
+      thr_put_bit(thr, 5, (lv < imm)? BIT4_1 : BIT4_0);
+      thr_put_bit(thr, 6, eq);
+
+      return true;
+}
+
+bool of_CMPIU(vthread_t thr, vvp_code_t cp)
+{
+      if (cp->number <= CPU_WORD_BITS)
+	    cp->opcode = &of_CMPIU_word;
+      else
+	    cp->opcode = &of_CMPIU_wide;
+
+      return cp->opcode(thr, cp);
+}
+
 bool of_CMPU_the_hard_way(vthread_t thr, vvp_code_t cp)
 {
       vvp_bit4_t eq = BIT4_1;
@@ -1831,7 +2034,7 @@ bool of_CMPU_the_hard_way(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
-bool of_CMPU(vthread_t thr, vvp_code_t cp)
+static bool of_CMPU_wide(vthread_t thr, vvp_code_t cp)
 {
       vvp_bit4_t eq = BIT4_1;
       vvp_bit4_t lt = BIT4_0;
@@ -1872,6 +2075,32 @@ bool of_CMPU(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
+static bool of_CMPU_word(vthread_t thr, vvp_code_t cp)
+{
+      unsigned long lv, rv;
+      if (! vector_to_word(thr, cp->bit_idx[0], cp->number, lv))
+	    return of_CMPU_the_hard_way(thr, cp);
+      if (! vector_to_word(thr, cp->bit_idx[1], cp->number, rv))
+	    return of_CMPU_the_hard_way(thr, cp);
+
+      vvp_bit4_t eq = (lv == rv)? BIT4_1 : BIT4_0;
+      thr_put_bit(thr, 4, eq);
+      thr_put_bit(thr, 5, (lv < rv)? BIT4_1 : BIT4_0);
+      thr_put_bit(thr, 6, eq);
+
+      return true;
+}
+
+bool of_CMPU(vthread_t thr, vvp_code_t cp)
+{
+      if (cp->number <= CPU_WORD_BITS)
+	    cp->opcode = &of_CMPU_word;
+      else
+	    cp->opcode = &of_CMPU_wide;
+
+      return cp->opcode(thr, cp);
+}
+
 bool of_CMPX(vthread_t thr, vvp_code_t cp)
 {
       vvp_bit4_t eq = BIT4_1;
@@ -2190,8 +2419,7 @@ static bool do_disable(vthread_t thr, vthread_t match)
 	   %forks that this thread has done. */
       while (! thr->children.empty()) {
 
-	    vthread_t tmp = *(thr->children.begin());
-	    assert(tmp);
+	    vthread_t tmp = thr->children.front();
 	    assert(tmp->parent == thr);
 	    thr->i_am_joining = 0;
 	    if (do_disable(tmp, match))
@@ -2263,8 +2491,7 @@ bool of_DISABLE_FORK(vthread_t thr, vvp_code_t)
 
 	/* Disable any detached children. */
       while (! thr->detached_children.empty()) {
-	    vthread_t child = *(thr->detached_children.begin());
-	    assert(child);
+	    vthread_t child = thr->detached_children.front();
 	    assert(child->parent == thr);
 	      /* Disabling the children can never match the parent thread. */
 	    bool res = do_disable(child, thr);
@@ -2584,13 +2811,12 @@ bool of_END(vthread_t thr, vvp_code_t)
 
 	/* Fully detach any detached children. */
       while (! thr->detached_children.empty()) {
-	    vthread_t child = *(thr->detached_children.begin());
-	    assert(child);
+	    vthread_t child = thr->detached_children.front();
 	    assert(child->parent == thr);
 	    assert(child->i_am_detached);
+	    thr->detached_children.erase(child);
 	    child->parent = 0;
 	    child->i_am_detached = 0;
-	    thr->detached_children.erase(thr->detached_children.begin());
       }
 
 	/* It is an error to still have active children running at this
@@ -2618,7 +2844,7 @@ bool of_END(vthread_t thr, vvp_code_t)
       }
 
 	/* If this thread is not fully detached then remove it from the
-	 * parents detached_children set and reap it. */
+	 * parents detached_children list and reap it. */
       if (thr->i_am_detached) {
 	    vthread_t tmp = thr->parent;
 	    assert(tmp);
@@ -2809,13 +3035,15 @@ bool of_FORK(vthread_t thr, vvp_code_t cp)
 	   infer that this is a task or function call. */
       switch (cp->scope->get_type_code()) {
 	  case vpiFunction:
-	    thr->task_func_children.insert(child);
+	    child->i_am_task_func = 1;
+	    thr->task_func_count += 1;
 	    child->is_scheduled = 1;
 	    vthread_run(child);
 	    running_thread = thr;
 	    break;
 	  case vpiTask:
-	    thr->task_func_children.insert(child);
+	    child->i_am_task_func = 1;
+	    thr->task_func_count += 1;
 	    schedule_vthread(child, 0, true);
 	    break;
 	  default:
@@ -3134,8 +3362,7 @@ bool of_JMP1(vthread_t thr, vvp_code_t cp)
 
 static bool test_joinable(vthread_t thr, vthread_t child)
 {
-      set<vthread_t>::iterator cur = thr->task_func_children.find(child);
-      if (! thr->task_func_children.empty() && cur == thr->task_func_children.end())
+      if (thr->task_func_count > 0 && ! child->i_am_task_func)
 	    return false;
 
       return true;
@@ -3145,8 +3372,12 @@ static void do_join(vthread_t thr, vthread_t child)
 {
       assert(child->parent == thr);
 
-	/* Remove the thread from the task/function set if needed. */
-      thr->task_func_children.erase(child);
+	/* Remove the thread from the task/function count if needed. */
+      if (child->i_am_task_func) {
+	    assert(thr->task_func_count > 0);
+	    thr->task_func_count -= 1;
+	    child->i_am_task_func = 0;
+      }
 
         /* If the immediate child thread is in an automatic scope... */
       if (child->wt_context) {
@@ -3172,9 +3403,8 @@ bool of_JOIN(vthread_t thr, vvp_code_t)
 
 	// Are there any children that have already ended? If so, then
 	// join with that one.
-      for (set<vthread_t>::iterator cur = thr->children.begin()
-		 ; cur != thr->children.end() ; ++cur) {
-	    vthread_t curp = *cur;
+      for (vthread_t curp = thr->children.front()
+		 ; curp ; curp = curp->sib_next) {
 	    if (! curp->i_have_ended)
 		  continue;
 
@@ -3200,11 +3430,11 @@ bool of_JOIN_DETACH(vthread_t thr, vvp_code_t cp)
 {
       unsigned long count = cp->number;
 
-      assert(thr->task_func_children.empty());
+      assert(thr->task_func_count == 0);
       assert(count == thr->children.size());
 
       while (! thr->children.empty()) {
-	    vthread_t child = *thr->children.begin();
+	    vthread_t child = thr->children.front();
 	    assert(child->parent == thr);
 
 	      // We cannot detach automatic tasks/functions within an
@@ -3685,129 +3915,36 @@ bool of_LOAD_X1P(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
+/*
+ * Wide modulus uses the word based division of vvp_vector2_t on the
+ * magnitudes of the operands. The result takes the sign of the left
+ * operand.
+ */
 static void do_verylong_mod(vthread_t thr, vvp_code_t cp,
 			    bool left_is_neg, bool right_is_neg)
 {
-      bool out_is_neg = left_is_neg;
-      int len=cp->number;
-      unsigned char *a, *z, *t;
-      a = new unsigned char[len+1];
-      z = new unsigned char[len+1];
-      t = new unsigned char[len+1];
-
-      unsigned char carry;
-      unsigned char temp;
-
-      int mxa = -1, mxz = -1;
-      int i;
-      int current, copylen;
-
-      unsigned idx1 = cp->bit_idx[0];
-      unsigned idx2 = cp->bit_idx[1];
-
-      unsigned lb_carry = left_is_neg? 1 : 0;
-      unsigned rb_carry = right_is_neg? 1 : 0;
-      for (unsigned idx = 0 ;  idx < cp->number ;  idx += 1) {
-	    unsigned lb = thr_get_bit(thr, idx1);
-	    unsigned rb = thr_get_bit(thr, idx2);
-
-	    if ((lb | rb) & 2) {
-		  delete []t;
-		  delete []z;
-		  delete []a;
-		  goto x_out;
-	    }
-
-	    if (left_is_neg) {
-		  lb = (1-lb) + lb_carry;
-		  lb_carry = (lb & ~1)? 1 : 0;
-		  lb &= 1;
-	    }
-	    if (right_is_neg) {
-		  rb = (1-rb) + rb_carry;
-		  rb_carry = (rb & ~1)? 1 : 0;
-		  rb &= 1;
-	    }
-
-	    z[idx]=lb;
-	    a[idx]=1-rb;	// for 2s complement add..
-
-	    idx1 += 1;
-	    if (idx2 >= 4)
-		  idx2 += 1;
-      }
-
-      z[len]=0;
-      a[len]=1;
-
-      for(i=len-1;i>=0;i--) {
-	    if(! a[i]) {
-		  mxa=i;
-		  break;
-	    }
-      }
-
-      for(i=len-1;i>=0;i--) {
-	    if(z[i]) {
-		  mxz=i;
-		  break;
-	    }
-      }
-
-      if((mxa>mxz)||(mxa==-1)) {
-	    if(mxa==-1) {
-		  delete []t;
-		  delete []z;
-		  delete []a;
-		  goto x_out;
-	    }
-
-	    goto tally;
-      }
-
-      copylen = mxa + 2;
-      current = mxz - mxa;
-
-      while(current > -1) {
-	    carry = 1;
-	    for(i=0;i<copylen;i++) {
-		  temp = z[i+current] + a[i] + carry;
-		  t[i] = (temp&1);
-		  carry = (temp>>1);
-	    }
-
-	    if(carry) {
-		  for(i=0;i<copylen;i++) {
-			z[i+current] = t[i];
-		  }
-	    }
-
-	    current--;
-      }
+      unsigned adra = cp->bit_idx[0];
+      unsigned wid = cp->number;
 
- tally:
+      vvp_vector2_t lv (vthread_bits_to_vector(thr, adra, wid));
+      vvp_vector2_t rv (vthread_bits_to_vector(thr, cp->bit_idx[1], wid));
 
-      carry = out_is_neg? 1 : 0;
-      for (unsigned idx = 0 ;  idx < cp->number ;  idx += 1) {
-	    unsigned ob = z[idx];
-	    if (out_is_neg) {
-		  ob = (1-ob) + carry;
-		  carry = (ob & ~1)? 1 : 0;
-		  ob = ob & 1;
-	    }
-	    thr_put_bit(thr, cp->bit_idx[0]+idx, ob?BIT4_1:BIT4_0);
+      if (lv.is_NaN() || rv.is_NaN() || rv.is_zero()) {
+	    vvp_vector4_t tmp(wid, BIT4_X);
+	    thr->bits4.set_vec(adra, tmp);
+	    return;
       }
 
-      delete []t;
-      delete []z;
-      delete []a;
-      return;
+      if (left_is_neg)
+	    lv = -lv;
+      if (right_is_neg)
+	    rv = -rv;
 
- x_out:
-      for (unsigned idx = 0 ;  idx < cp->number ;  idx += 1)
-	    thr_put_bit(thr, cp->bit_idx[0]+idx, BIT4_X);
+      vvp_vector2_t res = lv % rv;
+      if (left_is_neg)
+	    res = -res;
 
-      return;
+      thr->bits4.set_vec(adra, vector2_to_vector4(res, wid));
 }
 
 bool of_MAX_WR(vthread_t thr, vvp_code_t)
@@ -4064,7 +4201,7 @@ bool of_MOVI(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
-bool of_MUL(vthread_t thr, vvp_code_t cp)
+static bool of_MUL_wide(vthread_t thr, vvp_code_t cp)
 {
       unsigned adra = cp->bit_idx[0];
       unsigned adrb = cp->bit_idx[1];
@@ -4122,6 +4259,37 @@ bool of_MUL(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
+static bool of_MUL_word(vthread_t thr, vvp_code_t cp)
+{
+      unsigned adra = cp->bit_idx[0];
+      unsigned adrb = cp->bit_idx[1];
+      unsigned wid = cp->number;
+
+      assert(adra >= 4);
+
+      unsigned long lv, rv;
+      if (vector_to_word(thr, adra, wid, lv)
+	  && vector_to_word(thr, adrb, wid, rv)) {
+	    lv *= rv;
+	    thr->bits4.setarray(adra, wid, &lv);
+      } else {
+	    vvp_vector4_t tmp (wid, BIT4_X);
+	    thr->bits4.set_vec(adra, tmp);
+      }
+
+      return true;
+}
+
+bool of_MUL(vthread_t thr, vvp_code_t cp)
+{
+      if (cp->number <= CPU_WORD_BITS)
+	    cp->opcode = &of_MUL_word;
+      else
+	    cp->opcode = &of_MUL_wide;
+
+      return cp->opcode(thr, cp);
+}
+
 bool of_MUL_WR(vthread_t thr, vvp_code_t)
 {
       double r = thr->pop_real();
@@ -4131,7 +4299,7 @@ bool of_MUL_WR(vthread_t thr, vvp_code_t)
       return true;
 }
 
-bool of_MULI(vthread_t thr, vvp_code_t cp)
+static bool of_MULI_wide(vthread_t thr, vvp_code_t cp)
 {
       unsigned adr = cp->bit_idx[0];
       unsigned long imm = cp->bit_idx[1];
@@ -4166,6 +4334,36 @@ bool of_MULI(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
+static bool of_MULI_word(vthread_t thr, vvp_code_t cp)
+{
+      unsigned adra = cp->bit_idx[0];
+      unsigned long imm = cp->bit_idx[1];
+      unsigned wid = cp->number;
+
+      assert(adra >= 4);
+
+      unsigned long lv;
+      if (vector_to_word(thr, adra, wid, lv)) {
+	    lv *= imm;
+	    thr->bits4.setarray(adra, wid, &lv);
+      } else {
+	    vvp_vector4_t tmp (wid, BIT4_X);
+	    thr->bits4.set_vec(adra, tmp);
+      }
+
+      return true;
+}
+
+bool of_MULI(vthread_t thr, vvp_code_t cp)
+{
+      if (cp->number <= CPU_WORD_BITS)
+	    cp->opcode = &of_MULI_word;
+      else
+	    cp->opcode = &of_MULI_wide;
+
+      return cp->opcode(thr, cp);
+}
+
 static bool of_NAND_wide(vthread_t thr, vvp_code_t cp)
 {
       unsigned idx1 = cp->bit_idx[0];
@@ -4269,22 +4467,8 @@ bool of_NORR(vthread_t thr, vvp_code_t cp)
 {
       assert(cp->bit_idx[0] >= 4);
 
-      vvp_bit4_t lb = BIT4_1;
-      unsigned idx2 = cp->bit_idx[1];
-
-      for (unsigned idx = 0 ;  idx < cp->number ;  idx += 1) {
-
-	    vvp_bit4_t rb = thr_get_bit(thr, idx2+idx);
-	    if (rb == BIT4_1) {
-		  lb = BIT4_0;
-		  break;
-	    }
-
-	    if (rb != BIT4_0)
-		  lb = BIT4_X;
-      }
-
-      thr_put_bit(thr, cp->bit_idx[0], lb);
+      vvp_vector4_t val = vthread_bits_to_vector(thr, cp->bit_idx[1], cp->number);
+      thr_put_bit(thr, cp->bit_idx[0], ~val.reduce_or());
 
       return true;
 }
@@ -4304,22 +4488,8 @@ bool of_ANDR(vthread_t thr, vvp_code_t cp)
 {
       assert(cp->bit_idx[0] >= 4);
 
-      vvp_bit4_t lb = BIT4_1;
-      unsigned idx2 = cp->bit_idx[1];
-
-      for (unsigned idx = 0 ;  idx < cp->number ;  idx += 1) {
-
-	    vvp_bit4_t rb = thr_get_bit(thr, idx2+idx);
-	    if (rb == BIT4_0) {
-		  lb = BIT4_0;
-		  break;
-	    }
-
-	    if (rb != BIT4_1)
-		  lb = BIT4_X;
-      }
-
-      thr_put_bit(thr, cp->bit_idx[0], lb);
+      vvp_vector4_t val = vthread_bits_to_vector(thr, cp->bit_idx[1], cp->number);
+      thr_put_bit(thr, cp->bit_idx[0], val.reduce_and());
 
       return true;
 }
@@ -4328,22 +4498,8 @@ bool of_NANDR(vthread_t thr, vvp_code_t cp)
 {
       assert(cp->bit_idx[0] >= 4);
 
-      vvp_bit4_t lb = BIT4_0;
-      unsigned idx2 = cp->bit_idx[1];
-
-      for (unsigned idx = 0 ;  idx < cp->number ;  idx += 1) {
-
-	    vvp_bit4_t rb = thr_get_bit(thr, idx2+idx);
-	    if (rb == BIT4_0) {
-		  lb = BIT4_1;
-		  break;
-	    }
-
-	    if (rb != BIT4_1)
-		  lb = BIT4_X;
-      }
-
-      thr_put_bit(thr, cp->bit_idx[0], lb);
+      vvp_vector4_t val = vthread_bits_to_vector(thr, cp->bit_idx[1], cp->number);
+      thr_put_bit(thr, cp->bit_idx[0], ~val.reduce_and());
 
       return true;
 }
@@ -4352,22 +4508,8 @@ bool of_ORR(vthread_t thr, vvp_code_t cp)
 {
       assert(cp->bit_idx[0] >= 4);
 
-      vvp_bit4_t lb = BIT4_0;
-      unsigned idx2 = cp->bit_idx[1];
-
-      for (unsigned idx = 0 ;  idx < cp->number ;  idx += 1) {
-
-	    vvp_bit4_t rb = thr_get_bit(thr, idx2+idx);
-	    if (rb == BIT4_1) {
-		  lb = BIT4_1;
-		  break;
-	    }
-
-	    if (rb != BIT4_0)
-		  lb = BIT4_X;
-      }
-
-      thr_put_bit(thr, cp->bit_idx[0], lb);
+      vvp_vector4_t val = vthread_bits_to_vector(thr, cp->bit_idx[1], cp->number);
+      thr_put_bit(thr, cp->bit_idx[0], val.reduce_or());
 
       return true;
 }
@@ -4376,21 +4518,8 @@ bool of_XORR(vthread_t thr, vvp_code_t cp)
 {
       assert(cp->bit_idx[0] >= 4);
 
-      vvp_bit4_t lb = BIT4_0;
-      unsigned idx2 = cp->bit_idx[1];
-
-      for (unsigned idx = 0 ;  idx < cp->number ;  idx += 1) {
-
-	    vvp_bit4_t rb = thr_get_bit(thr, idx2+idx);
-	    if (rb == BIT4_1)
-		  lb = ~lb;
-	    else if (rb != BIT4_0) {
-		  lb = BIT4_X;
-		  break;
-	    }
-      }
-
-      thr_put_bit(thr, cp->bit_idx[0], lb);
+      vvp_vector4_t val = vthread_bits_to_vector(thr, cp->bit_idx[1], cp->number);
+      thr_put_bit(thr, cp->bit_idx[0], val.reduce_xor());
 
       return true;
 }
@@ -4399,21 +4528,8 @@ bool of_XNORR(vthread_t thr, vvp_code_t cp)
 {
       assert(cp->bit_idx[0] >= 4);
 
-      vvp_bit4_t lb = BIT4_1;
-      unsigned idx2 = cp->bit_idx[1];
-
-      for (unsigned idx = 0 ;  idx < cp->number ;  idx += 1) {
-
-	    vvp_bit4_t rb = thr_get_bit(thr, idx2+idx);
-	    if (rb == BIT4_1)
-		  lb = ~lb;
-	    else if (rb != BIT4_0) {
-		  lb = BIT4_X;
-		  break;
-	    }
-      }
-
-      thr_put_bit(thr, cp->bit_idx[0], lb);
+      vvp_vector4_t val = vthread_bits_to_vector(thr, cp->bit_idx[1], cp->number);
+      thr_put_bit(thr, cp->bit_idx[0], ~val.reduce_xor());
 
       return true;
 }
@@ -5417,7 +5533,7 @@ bool of_STORE_STRA(vthread_t thr, vvp_code_t cp)
 }
 
 
-bool of_SUB(vthread_t thr, vvp_code_t cp)
+static bool of_SUB_wide(vthread_t thr, vvp_code_t cp)
 {
       assert(cp->bit_idx[0] >= 4);
 
@@ -5452,6 +5568,37 @@ bool of_SUB(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
+static bool of_SUB_word(vthread_t thr, vvp_code_t cp)
+{
+      unsigned adra = cp->bit_idx[0];
+      unsigned adrb = cp->bit_idx[1];
+      unsigned wid = cp->number;
+
+      assert(adra >= 4);
+
+      unsigned long lv, rv;
+      if (vector_to_word(thr, adra, wid, lv)
+	  && vector_to_word(thr, adrb, wid, rv)) {
+	    lv -= rv;
+	    thr->bits4.setarray(adra, wid, &lv);
+      } else {
+	    vvp_vector4_t tmp (wid, BIT4_X);
+	    thr->bits4.set_vec(adra, tmp);
+      }
+
+      return true;
+}
+
+bool of_SUB(vthread_t thr, vvp_code_t cp)
+{
+      if (cp->number <= CPU_WORD_BITS)
+	    cp->opcode = &of_SUB_word;
+      else
+	    cp->opcode = &of_SUB_wide;
+
+      return cp->opcode(thr, cp);
+}
+
 bool of_SUB_WR(vthread_t thr, vvp_code_t)
 {
       double r = thr->pop_real();
@@ -5460,7 +5607,7 @@ bool of_SUB_WR(vthread_t thr, vvp_code_t)
       return true;
 }
 
-bool of_SUBI(vthread_t thr, vvp_code_t cp)
+static bool of_SUBI_wide(vthread_t thr, vvp_code_t cp)
 {
       assert(cp->bit_idx[0] >= 4);
 
@@ -5496,6 +5643,36 @@ bool of_SUBI(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
+static bool of_SUBI_word(vthread_t thr, vvp_code_t cp)
+{
+      unsigned adra = cp->bit_idx[0];
+      unsigned long imm = cp->bit_idx[1];
+      unsigned wid = cp->number;
+
+      assert(adra >= 4);
+
+      unsigned long lv;
+      if (vector_to_word(thr, adra, wid, lv)) {
+	    lv -= imm;
+	    thr->bits4.setarray(adra, wid, &lv);
+      } else {
+	    vvp_vector4_t tmp (wid, BIT4_X);
+	    thr->bits4.set_vec(adra, tmp);
+      }
+
+      return true;
+}
+
+bool of_SUBI(vthread_t thr, vvp_code_t cp)
+{
+      if (cp->number <= CPU_WORD_BITS)
+	    cp->opcode = &of_SUBI_word;
+      else
+	    cp->opcode = &of_SUBI_wide;
+
+      return cp->opcode(thr, cp);
+}
+
 /*
  * %substr <first>, <last>
  * Pop a string, take the substring (SystemVerilog style), and return
@@ -5607,9 +5784,15 @@ bool of_WAIT(vthread_t thr, vvp_code_t cp)
       assert(! thr->waiting_for_event);
       thr->waiting_for_event = 1;
 
-	/* Add this thread to the list in the event. */
-      waitable_hooks_s*ep = dynamic_cast<waitable_hooks_s*> (cp->net->fun);
-      assert(ep);
+	/* Add this thread to the list in the event. The functor does
+	   not change, so look up its waitable interface the first
+	   time and keep it in the instruction. */
+      waitable_hooks_s*ep = cp->waitable;
+      if (ep == 0) {
+	    ep = dynamic_cast<waitable_hooks_s*> (cp->net->fun);
+	    assert(ep);
+	    cp->waitable = ep;
+      }
       thr->wait_next = ep->add_waiting_thread(thr);
 
 	/* Return false to suspend this thread. */
@@ -5641,10 +5824,21 @@ bool of_WAIT_FORK(vthread_t thr, vvp_code_t)
 }
 
 
-bool of_XNOR(vthread_t thr, vvp_code_t cp)
+static bool of_XNOR_wide(vthread_t thr, vvp_code_t cp)
 {
-      assert(cp->bit_idx[0] >= 4);
+      unsigned idx1 = cp->bit_idx[0];
+      unsigned idx2 = cp->bit_idx[1];
+      unsigned wid = cp->number;
 
+      vvp_vector4_t val = vthread_bits_to_vector(thr, idx1, wid);
+      val ^= vthread_bits_to_vector(thr, idx2, wid);
+      thr->bits4.set_vec(idx1, ~val);
+
+      return true;
+}
+
+static bool of_XNOR_narrow(vthread_t thr, vvp_code_t cp)
+{
       unsigned idx1 = cp->bit_idx[0];
       unsigned idx2 = cp->bit_idx[1];
 
@@ -5662,34 +5856,41 @@ bool of_XNOR(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
-
-bool of_XOR(vthread_t thr, vvp_code_t cp)
+bool of_XNOR(vthread_t thr, vvp_code_t cp)
 {
       assert(cp->bit_idx[0] >= 4);
 
-      unsigned idx1 = cp->bit_idx[0];
-      unsigned idx2 = cp->bit_idx[1];
+      if (cp->number <= 4)
+	    cp->opcode = &of_XNOR_narrow;
+      else
+	    cp->opcode = &of_XNOR_wide;
 
-      for (unsigned idx = 0 ;  idx < cp->number ;  idx += 1) {
+      return cp->opcode(thr, cp);
+}
 
-	    vvp_bit4_t lb = thr_get_bit(thr, idx1);
-	    vvp_bit4_t rb = thr_get_bit(thr, idx2);
+static bool of_XOR_wide(vthread_t thr, vvp_code_t cp)
+{
+      unsigned idx1 = cp->bit_idx[0];
+      unsigned idx2 = cp->bit_idx[1];
+      unsigned wid = cp->number;
 
-	    if ((lb == BIT4_1) && (rb == BIT4_1)) {
-		  thr_put_bit(thr, idx1, BIT4_0);
+      vvp_vector4_t val = vthread_bits_to_vector(thr, idx1, wid);
+      val ^= vthread_bits_to_vector(thr, idx2, wid);
+      thr->bits4.set_vec(idx1, val);
 
-	    } else if ((lb == BIT4_0) && (rb == BIT4_0)) {
-		  thr_put_bit(thr, idx1, BIT4_0);
+      return true;
+}
 
-	    } else if ((lb == BIT4_1) && (rb == BIT4_0)) {
-		  thr_put_bit(thr, idx1, BIT4_1);
+static bool of_XOR_narrow(vthread_t thr, vvp_code_t cp)
+{
+      unsigned idx1 = cp->bit_idx[0];
+      unsigned idx2 = cp->bit_idx[1];
 
-	    } else if ((lb == BIT4_0) && (rb == BIT4_1)) {
-		  thr_put_bit(thr, idx1, BIT4_1);
+      for (unsigned idx = 0 ;  idx < cp->number ;  idx += 1) {
 
-	    } else {
-		  thr_put_bit(thr, idx1, BIT4_X);
-	    }
+	    vvp_bit4_t lb = thr_get_bit(thr, idx1);
+	    vvp_bit4_t rb = thr_get_bit(thr, idx2);
+	    thr_put_bit(thr, idx1, lb ^ rb);
 
 	    idx1 += 1;
 	    if (idx2 >= 4)
@@ -5699,6 +5900,18 @@ bool of_XOR(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
+bool of_XOR(vthread_t thr, vvp_code_t cp)
+{
+      assert(cp->bit_idx[0] >= 4);
+
+      if (cp->number <= 4)
+	    cp->opcode = &of_XOR_narrow;
+      else
+	    cp->opcode = &of_XOR_wide;
+
+      return cp->opcode(thr, cp);
+}
+
 
 bool of_ZOMBIE(vthread_t thr, vvp_code_t)
 {
@@ -5713,56 +5926,78 @@ bool of_ZOMBIE(vthread_t thr, vvp_code_t)
 }
 
 /*
- * This is a phantom opcode used to call user defined functions. It
- * is used in code generated by the .ufunc statement. It contains a
- * pointer to the executable code of the function and a pointer to
- * a ufunc_core object that has all the port information about the
- * function.
+ * Call a user defined function on behalf of a .ufunc core. The
+ * function code is run synchronously to completion on a thread that
+ * the core keeps and reuses for every call, so a call does not need
+ * to create, schedule or delete a thread. A function may not contain
+ * any blocking statements, so vthread_run() can only return when the
+ * %end opcode is reached (or the function is disabled).
  */
-bool of_EXEC_UFUNC(vthread_t thr, vvp_code_t cp)
+void vthread_call_ufunc(ufunc_core*core)
 {
-      struct __vpiScope*child_scope = cp->ufunc_core_ptr->func_scope();
+      struct __vpiScope*child_scope = core->func_scope();
       assert(child_scope);
 
-      assert(thr->children.empty());
-
-        /* We can take a number of shortcuts because we know that a
-           continuous assignment can only occur in a static scope. */
-      assert(thr->wt_context == 0);
-      assert(thr->rd_context == 0);
-
         /* If an automatic function, allocate a context for this call. */
       vvp_context_t child_context = 0;
-      if (child_scope->is_automatic) {
+      if (child_scope->is_automatic)
             child_context = vthread_alloc_context(child_scope);
-            thr->wt_context = child_context;
-            thr->rd_context = child_context;
-      }
+
 	/* Copy all the inputs to the ufunc object to the port
 	   variables of the function. This copies all the values
 	   atomically. */
-      cp->ufunc_core_ptr->assign_bits_to_ports(child_context);
+      core->assign_bits_to_ports(child_context);
 
-	/* Create a temporary thread and run it immediately. A function
-           may not contain any blocking statements, so vthread_run() can
-           only return when the %end opcode is reached. */
-      vthread_t child = vthread_new(cp->cptr, child_scope);
+      vthread_t child = core->func_thread();
+      if (child == 0) {
+	    child = vthread_new(core->func_code(), child_scope);
+	    child->i_am_reusable = 1;
+	    core->set_func_thread(child);
+      } else {
+	      /* The last call left the thread ended and reaped (but
+		 not deleted). Put it back into its scope so that a
+		 %disable of the function can find it. */
+	    assert(child->i_have_ended);
+	    assert(child->parent == 0);
+	    assert(child->children.empty());
+	    child->pc = core->func_code();
+	    child->i_have_ended = 0;
+	    child_scope->threads.insert(child);
+      }
       child->wt_context = child_context;
       child->rd_context = child_context;
       child->is_scheduled = 1;
+
+      vthread_t save_running = running_thread;
       vthread_run(child);
-      running_thread = thr;
+      running_thread = save_running;
 
 	/* Now copy the output from the result variable to the output
 	   ports of the .ufunc device. */
-      cp->ufunc_core_ptr->finish_thread();
+      core->finish_thread();
 
         /* If an automatic function, free the context for this call. */
-      if (child_scope->is_automatic) {
+      if (child_scope->is_automatic)
             vthread_free_context(child_context, child_scope);
-            thr->wt_context = 0;
-            thr->rd_context = 0;
-      }
+}
+
+/*
+ * This is a phantom opcode used to call user defined functions. It
+ * is used in code generated by the .ufunc statement. It contains a
+ * pointer to the ufunc_core object that has all the port information
+ * about the function. The .ufunc core normally calls the function
+ * directly (see vthread_call_ufunc) so this is only reached if a
+ * thread is started at the stub code.
+ */
+bool of_EXEC_UFUNC(vthread_t thr, vvp_code_t cp)
+{
+      assert(thr->children.empty());
+
+        /* We can take a number of shortcuts because we know that a
+           continuous assignment can only occur in a static scope. */
+      assert(thr->wt_context == 0);
+      assert(thr->rd_context == 0);
 
+      vthread_call_ufunc(cp->ufunc_core_ptr);
       return true;
 }
@@ -131,4 +131,11 @@ extern double vthread_get_real_stack(struct vthread_s*thr, unsigned depth);
 /* This is used to actually delete a thread once we are done with it. */
 extern void vthread_delete(vthread_t thr);
 
+/*
+ * Run the function of a .ufunc core to completion, using the thread
+ * that the core keeps for that purpose, and deliver the result.
+ */
+class ufunc_core;
+extern void vthread_call_ufunc(ufunc_core*core);
+
 #endif
@@ -25,6 +25,7 @@
 # include  "resolv.h"
 # include  "schedule.h"
 # include  "statistics.h"
+# include  "ivl_digits.h"
 # include  <cstdio>
 # include  <cstring>
 # include  <cstdlib>
@@ -1015,6 +1016,47 @@ unsigned long* vvp_vector4_t::subarray(unsigned adr, unsigned wid) const
       return 0;
 }
 
+void vvp_vector4_t::subword4(unsigned adr, unsigned wid,
+			     unsigned long&abits, unsigned long&bbits) const
+{
+      assert(wid <= BITS_PER_WORD);
+
+      unsigned long atmp, btmp;
+      if (size_ <= BITS_PER_WORD) {
+	    atmp = abits_val_ >> adr;
+	    btmp = bbits_val_ >> adr;
+      } else {
+	      /* The subvector may straddle two words. */
+	    unsigned ptr = adr / BITS_PER_WORD;
+	    unsigned off = adr % BITS_PER_WORD;
+	    atmp = abits_ptr_[ptr] >> off;
+	    btmp = bbits_ptr_[ptr] >> off;
+	    if (off > 0 && (off+wid) > BITS_PER_WORD) {
+		  atmp |= abits_ptr_[ptr+1] << (BITS_PER_WORD-off);
+		  btmp |= bbits_ptr_[ptr+1] << (BITS_PER_WORD-off);
+	    }
+      }
+
+      if (wid < BITS_PER_WORD) {
+	    atmp &= (1UL << wid) - 1;
+	    btmp &= (1UL << wid) - 1;
+      }
+
+      abits = atmp;
+      bbits = btmp;
+}
+
+bool vvp_vector4_t::subword(unsigned adr, unsigned wid, unsigned long&val) const
+{
+      unsigned long atmp, btmp;
+      subword4(adr, wid, atmp, btmp);
+      if (btmp)
+	    return false;
+
+      val = atmp;
+      return true;
+}
+
 void vvp_vector4_t::setarray(unsigned adr, unsigned wid, const unsigned long*val)
 {
       assert(adr+wid <= size_);
@@ -1386,22 +1428,23 @@ bool vvp_vector4_t::eeq(const vvp_vector4_t&that) const
 		  && (bbits_val_ == that.bbits_val_);
       }
 
+	// Collect the differences of all the words without branching
+	// so that the compiler can vectorize the loop.
       unsigned words = size_ / BITS_PER_WORD;
+      unsigned long diff = 0;
       for (unsigned idx = 0 ;  idx < words ;  idx += 1) {
-	    if (abits_ptr_[idx] != that.abits_ptr_[idx])
-		  return false;
-	    if (bbits_ptr_[idx] != that.bbits_ptr_[idx])
-		  return false;
+	    diff |= abits_ptr_[idx] ^ that.abits_ptr_[idx];
+	    diff |= bbits_ptr_[idx] ^ that.bbits_ptr_[idx];
       }
 
       unsigned long mask = size_%BITS_PER_WORD;
       if (mask > 0) {
 	    mask = (1UL << mask) - 1;
-	    return (abits_ptr_[words]&mask) == (that.abits_ptr_[words]&mask)
-		  && (bbits_ptr_[words]&mask) == (that.bbits_ptr_[words]&mask);
+	    diff |= (abits_ptr_[words] ^ that.abits_ptr_[words]) & mask;
+	    diff |= (bbits_ptr_[words] ^ that.bbits_ptr_[words]) & mask;
       }
 
-      return true;
+      return diff == 0;
 }
 
 bool vvp_vector4_t::eq_xz(const vvp_vector4_t&that) const
@@ -1450,18 +1493,17 @@ bool vvp_vector4_t::has_xz() const
       }
 
       unsigned words = size_ / BITS_PER_WORD;
-      for (unsigned idx = 0 ; idx < words ; idx += 1) {
-	    if (bbits_ptr_[idx])
-		  return true;
-      }
+      unsigned long xz = 0;
+      for (unsigned idx = 0 ; idx < words ; idx += 1)
+	    xz |= bbits_ptr_[idx];
 
       unsigned long mask = size_%BITS_PER_WORD;
       if (mask > 0) {
 	    mask = -1UL >> (BITS_PER_WORD - mask);
-	    return bbits_ptr_[words]&mask;
+	    xz |= bbits_ptr_[words]&mask;
       }
 
-      return false;
+      return xz != 0;
 }
 
 void vvp_vector4_t::change_z2x()
@@ -1607,6 +1649,135 @@ vvp_vector4_t& vvp_vector4_t::operator |= (const vvp_vector4_t&that)
       return *this;
 }
 
+vvp_vector4_t& vvp_vector4_t::operator ^= (const vvp_vector4_t&that)
+{
+	// Any X or Z bit makes the result bit X, otherwise the value
+	// bits are simply exclusive or-ed together.
+      if (size_ <= BITS_PER_WORD) {
+	    bbits_val_ |= that.bbits_val_;
+	    abits_val_ = (abits_val_ ^ that.abits_val_) | bbits_val_;
+
+      } else {
+	    unsigned words = (size_ + BITS_PER_WORD - 1) / BITS_PER_WORD;
+	    for (unsigned idx = 0; idx < words ; idx += 1) {
+		  unsigned long xz = bbits_ptr_[idx] | that.bbits_ptr_[idx];
+		  abits_ptr_[idx] = (abits_ptr_[idx] ^ that.abits_ptr_[idx]) | xz;
+		  bbits_ptr_[idx] = xz;
+	    }
+      }
+
+      return *this;
+}
+
+/*
+ * The reduction methods scan all the words of the vector without
+ * branching, collecting the bits that decide the result, and only
+ * then look at what was found. The loops are simple enough for the
+ * compiler to vectorize for very wide vectors. The unused bits of
+ * the last word are masked off.
+ */
+vvp_bit4_t vvp_vector4_t::reduce_and() const
+{
+      unsigned long zero, xz;
+
+      if (size_ <= BITS_PER_WORD) {
+	    unsigned long mask = (size_<BITS_PER_WORD)? (1UL<<size_)-1UL : -1UL;
+	    zero = ~abits_val_ & ~bbits_val_ & mask;
+	    xz = bbits_val_ & mask;
+
+      } else {
+	    unsigned words = size_ / BITS_PER_WORD;
+	    zero = 0;
+	    xz = 0;
+	    for (unsigned idx = 0 ; idx < words ; idx += 1) {
+		  zero |= ~abits_ptr_[idx] & ~bbits_ptr_[idx];
+		  xz |= bbits_ptr_[idx];
+	    }
+
+	    unsigned long mask = size_%BITS_PER_WORD;
+	    if (mask > 0) {
+		  mask = (1UL << mask) - 1;
+		  zero |= ~abits_ptr_[words] & ~bbits_ptr_[words] & mask;
+		  xz |= bbits_ptr_[words] & mask;
+	    }
+      }
+
+      if (zero)
+	    return BIT4_0;
+      if (xz)
+	    return BIT4_X;
+      return BIT4_1;
+}
+
+vvp_bit4_t vvp_vector4_t::reduce_or() const
+{
+      unsigned long one, xz;
+
+      if (size_ <= BITS_PER_WORD) {
+	    unsigned long mask = (size_<BITS_PER_WORD)? (1UL<<size_)-1UL : -1UL;
+	    one = abits_val_ & ~bbits_val_ & mask;
+	    xz = bbits_val_ & mask;
+
+      } else {
+	    unsigned words = size_ / BITS_PER_WORD;
+	    one = 0;
+	    xz = 0;
+	    for (unsigned idx = 0 ; idx < words ; idx += 1) {
+		  one |= abits_ptr_[idx] & ~bbits_ptr_[idx];
+		  xz |= bbits_ptr_[idx];
+	    }
+
+	    unsigned long mask = size_%BITS_PER_WORD;
+	    if (mask > 0) {
+		  mask = (1UL << mask) - 1;
+		  one |= abits_ptr_[words] & ~bbits_ptr_[words] & mask;
+		  xz |= bbits_ptr_[words] & mask;
+	    }
+      }
+
+      if (one)
+	    return BIT4_1;
+      if (xz)
+	    return BIT4_X;
+      return BIT4_0;
+}
+
+vvp_bit4_t vvp_vector4_t::reduce_xor() const
+{
+      unsigned long par, xz;
+
+      if (size_ <= BITS_PER_WORD) {
+	    unsigned long mask = (size_<BITS_PER_WORD)? (1UL<<size_)-1UL : -1UL;
+	    par = abits_val_ & mask;
+	    xz = bbits_val_ & mask;
+
+      } else {
+	    unsigned words = size_ / BITS_PER_WORD;
+	    par = 0;
+	    xz = 0;
+	    for (unsigned idx = 0 ; idx < words ; idx += 1) {
+		  par ^= abits_ptr_[idx];
+		  xz |= bbits_ptr_[idx];
+	    }
+
+	    unsigned long mask = size_%BITS_PER_WORD;
+	    if (mask > 0) {
+		  mask = (1UL << mask) - 1;
+		  par ^= abits_ptr_[words] & mask;
+		  xz |= bbits_ptr_[words] & mask;
+	    }
+      }
+
+      if (xz)
+	    return BIT4_X;
+
+	// Fold the word in half until one bit holds the parity.
+      for (unsigned shift = BITS_PER_WORD/2 ; shift > 0 ; shift /= 2)
+	    par ^= par >> shift;
+
+      return (par & 1)? BIT4_1 : BIT4_0;
+}
+
 /*
 * Add an integer to the vvp_vector4_t in place, bit by bit so that
 * there is no size limitations.
@@ -2382,44 +2553,25 @@ vvp_vector2_t pow(const vvp_vector2_t&x, vvp_vector2_t&y)
       return res;
 }
 
-static void multiply_long(unsigned long a, unsigned long b,
-			  unsigned long&low, unsigned long&high)
+/*
+ * res[0..rwords) = the low rwords words of a*b.
+ */
+void multiply_words(unsigned long*res, unsigned rwords,
+		    const unsigned long*a, unsigned awords,
+		    const unsigned long*b, unsigned bwords)
 {
-      assert(sizeof(unsigned long) %2 == 0);
+      unsigned long*ad = new unsigned long[2*(awords+bwords+rwords)];
+      unsigned long*bd = ad + 2*awords;
+      unsigned long*rd = bd + 2*bwords;
 
-      const unsigned long word_mask = (1UL << 4UL*sizeof(a)) - 1UL;
-      unsigned long tmpa;
-      unsigned long tmpb;
-      unsigned long res[4];
+      split_digits(ad, a, awords);
+      split_digits(bd, b, bwords);
 
-      tmpa = a & word_mask;
-      tmpb = b & word_mask;
-      res[0] = tmpa * tmpb;
-      res[1] = res[0] >> 4UL*sizeof(unsigned long);
-      res[0] &= word_mask;
+      mul_digits(rd, 2*rwords, ad, 2*awords, bd, 2*bwords);
 
-      tmpa = (a >> 4UL*sizeof(unsigned long)) & word_mask;
-      tmpb = b & word_mask;
-      res[1] += tmpa * tmpb;
-      res[2] = res[1] >> 4UL*sizeof(unsigned long);
-      res[1] &= word_mask;
+      join_digits(res, rd, rwords);
 
-      tmpa = a & word_mask;
-      tmpb = (b >> 4UL*sizeof(unsigned long)) & word_mask;
-      res[1] += tmpa * tmpb;
-      res[2] += res[1] >> 4UL*sizeof(unsigned long);
-      res[3]  = res[2] >> 4UL*sizeof(unsigned long);
-      res[1] &= word_mask;
-      res[2] &= word_mask;
-
-      tmpa = (a >> 4UL*sizeof(unsigned long)) & word_mask;
-      tmpb = (b >> 4UL*sizeof(unsigned long)) & word_mask;
-      res[2] += tmpa * tmpb;
-      res[3] += res[2] >> 4UL*sizeof(unsigned long);
-      res[2] &= word_mask;
-
-      high = (res[3] << 4UL*sizeof(unsigned long)) | res[2];
-      low  = (res[1] << 4UL*sizeof(unsigned long)) | res[0];
+      delete[]ad;
 }
 
 /*
@@ -2435,38 +2587,15 @@ vvp_vector2_t operator * (const vvp_vector2_t&a, const vvp_vector2_t&b)
       unsigned bwords = (b.wid_ + bits_per_word - 1) / bits_per_word;
       unsigned rwords = (r.wid_ + bits_per_word - 1) / bits_per_word;
 
-      for (unsigned bdx = 0 ;  bdx < bwords ;  bdx += 1) {
-	    unsigned long tmpb = b.vec_[bdx];
-	    if (tmpb == 0)
-		  continue;
-
-	    for (unsigned adx = 0 ;  adx < awords ;  adx += 1) {
-		  unsigned long tmpa = a.vec_[adx];
-		  if (tmpa == 0)
-			continue;
-
-		  unsigned long low, hig;
-		  multiply_long(tmpa, tmpb, low, hig);
-
-		  unsigned long carry = 0;
-		  for (unsigned sdx = 0
-			     ; (adx+bdx+sdx) < rwords
-			     ;  sdx += 1) {
-
-			r.vec_[adx+bdx+sdx] = add_carry(r.vec_[adx+bdx+sdx],
-							low, carry);
-			low = hig;
-			hig = 0;
-		  }
-	    }
-      }
-
+      if (rwords > 0)
+	    multiply_words(r.vec_, rwords, a.vec_, awords, b.vec_, bwords);
 
       return r;
 }
 
-static void div_mod (vvp_vector2_t dividend, vvp_vector2_t divisor,
-		     vvp_vector2_t&quotient, vvp_vector2_t&remainder)
+void vvp_vector2_t::div_mod_(const vvp_vector2_t&dividend,
+			     const vvp_vector2_t&divisor,
+			     vvp_vector2_t&quotient, vvp_vector2_t&remainder)
 {
 
       quotient = vvp_vector2_t(0, dividend.size());
@@ -2481,29 +2610,128 @@ static void div_mod (vvp_vector2_t dividend, vvp_vector2_t divisor,
 	    return;
       }
 
-      vvp_vector2_t mask (1, dividend.size());
+      remainder = vvp_vector2_t(0, dividend.size());
+
+      const unsigned words = (dividend.wid_ + BITS_PER_WORD-1) / BITS_PER_WORD;
+      unsigned dwords = (divisor.wid_ + BITS_PER_WORD-1) / BITS_PER_WORD;
+      while (divisor.vec_[dwords-1] == 0)
+	    dwords -= 1;
 
-	// Make the dividend 1 bit larger to prevent overflow of
-	// divtmp in startup.
-      dividend = vvp_vector2_t(dividend, dividend.size()+1);
-      vvp_vector2_t divtmp (divisor, dividend.size());
+      const unsigned long dtop = divisor.vec_[dwords-1];
 
-      while (divtmp < dividend) {
-	    divtmp <<= 1;
-	    mask <<= 1;
+	// Both fit in a word, so use the native operators.
+      if (words == 1) {
+	    quotient.vec_[0] = dividend.vec_[0] / dtop;
+	    remainder.vec_[0] = dividend.vec_[0] % dtop;
+	    return;
       }
 
-      while (dividend >= divisor) {
-	    if (divtmp <= dividend) {
-		  dividend -= divtmp;
-		  quotient += mask;
+	// Dividing by a power of 2 is a shift and a mask.
+      if ((dtop & (dtop-1)) == 0) {
+	    bool pow2 = true;
+	    for (unsigned idx = 0 ;  idx+1 < dwords ;  idx += 1) {
+		  if (divisor.vec_[idx] != 0) {
+			pow2 = false;
+			break;
+		  }
 	    }
 
-	    divtmp >>= 1;
-	    mask >>= 1;
+	    if (pow2) {
+		  unsigned shift = (dwords-1) * BITS_PER_WORD;
+		  for (unsigned long tmp = dtop ;  tmp > 1 ;  tmp >>= 1)
+			shift += 1;
+
+		  quotient = dividend;
+		  quotient >>= shift;
+
+		  for (unsigned idx = 0 ;  idx < words ;  idx += 1) {
+			unsigned base = idx * BITS_PER_WORD;
+			if (base >= shift)
+			      break;
+			remainder.vec_[idx] = dividend.vec_[idx];
+			if (shift - base < BITS_PER_WORD)
+			      remainder.vec_[idx] &= (1UL << (shift-base)) - 1UL;
+		  }
+		  return;
+	    }
+      }
+
+	// A divisor that fits in a half word can do a simple short
+	// division, one half word digit at a time.
+      if (dwords == 1 && dtop <= HALF_MASK) {
+	    unsigned long rem = 0;
+	    for (unsigned idx = words ;  idx > 0 ;  idx -= 1) {
+		  unsigned long word = dividend.vec_[idx-1];
+		  unsigned long tmp = (rem << HALF_BITS) | (word >> HALF_BITS);
+		  unsigned long qhi = tmp / dtop;
+		  rem = tmp % dtop;
+		  tmp = (rem << HALF_BITS) | (word & HALF_MASK);
+		  rem = tmp % dtop;
+		  quotient.vec_[idx-1] = (qhi << HALF_BITS) | (tmp / dtop);
+	    }
+	    remainder.vec_[0] = rem;
+	    return;
+      }
+
+	// Otherwise split the operands into half word digits and do a
+	// full long division. Normalize by shifting both operands so
+	// that the top bit of the divisor is set.
+      unsigned m = 2 * words;
+      unsigned n = 2 * dwords;
+      unsigned long*un = new unsigned long[m + 1 + n + m];
+      unsigned long*vn = un + m + 1;
+      unsigned long*qn = vn + n;
+
+      for (unsigned idx = 0 ;  idx < words ;  idx += 1) {
+	    un[2*idx+0] = dividend.vec_[idx] & HALF_MASK;
+	    un[2*idx+1] = dividend.vec_[idx] >> HALF_BITS;
+      }
+      for (unsigned idx = 0 ;  idx < dwords ;  idx += 1) {
+	    vn[2*idx+0] = divisor.vec_[idx] & HALF_MASK;
+	    vn[2*idx+1] = divisor.vec_[idx] >> HALF_BITS;
+      }
+      while (un[m-1] == 0)
+	    m -= 1;
+      while (vn[n-1] == 0)
+	    n -= 1;
+      assert(n >= 2 && m >= n);
+
+      unsigned norm = 0;
+      while ((vn[n-1] << norm) >> (HALF_BITS-1) == 0)
+	    norm += 1;
+
+      if (norm > 0) {
+	    for (unsigned idx = n-1 ;  idx > 0 ;  idx -= 1)
+		  vn[idx] = ((vn[idx] << norm) | (vn[idx-1] >> (HALF_BITS-norm)))
+			& HALF_MASK;
+	    vn[0] = (vn[0] << norm) & HALF_MASK;
+
+	    un[m] = un[m-1] >> (HALF_BITS-norm);
+	    for (unsigned idx = m-1 ;  idx > 0 ;  idx -= 1)
+		  un[idx] = ((un[idx] << norm) | (un[idx-1] >> (HALF_BITS-norm)))
+			& HALF_MASK;
+	    un[0] = (un[0] << norm) & HALF_MASK;
+      } else {
+	    un[m] = 0;
+      }
+
+      divide_digits(un, m, vn, n, qn);
+
+      for (unsigned idx = 0 ;  idx <= m-n ;  idx += 1) {
+	    unsigned shift = (idx % 2) * HALF_BITS;
+	    quotient.vec_[idx/2] |= qn[idx] << shift;
+      }
+
+	// Unnormalize the remainder.
+      for (unsigned idx = 0 ;  idx < n ;  idx += 1) {
+	    unsigned long digit = un[idx] >> norm;
+	    if (norm > 0 && idx+1 < n)
+		  digit |= (un[idx+1] << (HALF_BITS-norm)) & HALF_MASK;
+	    unsigned shift = (idx % 2) * HALF_BITS;
+	    remainder.vec_[idx/2] |= digit << shift;
       }
 
-      remainder = vvp_vector2_t(dividend, mask.size());
+      delete[]un;
 }
 
 vvp_vector2_t operator - (const vvp_vector2_t&that)
@@ -2525,7 +2753,7 @@ vvp_vector2_t operator / (const vvp_vector2_t&dividend,
 			  const vvp_vector2_t&divisor)
 {
       vvp_vector2_t quot, rem;
-      div_mod(dividend, divisor, quot, rem);
+      vvp_vector2_t::div_mod_(dividend, divisor, quot, rem);
       return quot;
 }
 
@@ -2533,7 +2761,7 @@ vvp_vector2_t operator % (const vvp_vector2_t&dividend,
 			  const vvp_vector2_t&divisor)
 {
       vvp_vector2_t quot, rem;
-      div_mod(dividend, divisor, quot, rem);
+      vvp_vector2_t::div_mod_(dividend, divisor, quot, rem);
       return rem;
 }
 
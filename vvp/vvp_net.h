@@ -251,6 +251,13 @@ class vvp_vector4_t {
 	// array of longs, or a nil pointer if an XZ bit was detected
 	// in the array.
       unsigned long*subarray(unsigned idx, unsigned size) const;
+	// Get no more than a word of 2-value bits for the subvector
+	// into val. Return false if an XZ bit was detected.
+      bool subword(unsigned idx, unsigned size, unsigned long&val) const;
+	// Get no more than a word of 4-value bits for the subvector,
+	// in the abits/bbits encoding described below.
+      void subword4(unsigned idx, unsigned size,
+		    unsigned long&abits, unsigned long&bbits) const;
       void setarray(unsigned idx, unsigned size, const unsigned long*val);
 
 	// Set a 4-value bit or subvector into the vector. Return true
@@ -285,8 +292,15 @@ class vvp_vector4_t {
       void invert();
       vvp_vector4_t& operator &= (const vvp_vector4_t&that);
       vvp_vector4_t& operator |= (const vvp_vector4_t&that);
+      vvp_vector4_t& operator ^= (const vvp_vector4_t&that);
       vvp_vector4_t& operator += (int64_t);
 
+	// Reduce all the bits of the vector to a single bit. Z bits
+	// are treated as X bits.
+      vvp_bit4_t reduce_and() const;
+      vvp_bit4_t reduce_or() const;
+      vvp_bit4_t reduce_xor() const;
+
     private:
 	// Number of vvp_bit4_t bits that can be shoved into a word.
       enum { BITS_PER_WORD = 8*sizeof(unsigned long) };
@@ -608,6 +622,10 @@ class vvp_vector2_t {
 				       const vvp_vector2_t&);
       friend vvp_vector2_t operator * (const vvp_vector2_t&,
 				       const vvp_vector2_t&);
+      friend vvp_vector2_t operator / (const vvp_vector2_t&,
+				       const vvp_vector2_t&);
+      friend vvp_vector2_t operator % (const vvp_vector2_t&,
+				       const vvp_vector2_t&);
       friend bool operator >  (const vvp_vector2_t&, const vvp_vector2_t&);
       friend bool operator >= (const vvp_vector2_t&, const vvp_vector2_t&);
       friend bool operator <  (const vvp_vector2_t&, const vvp_vector2_t&);
@@ -662,6 +680,9 @@ class vvp_vector2_t {
     private:
       void copy_from_that_(const vvp_vector2_t&that);
       void copy_from_that_(const vvp_vector4_t&that);
+      static void div_mod_(const vvp_vector2_t&dividend,
+			   const vvp_vector2_t&divisor,
+			   vvp_vector2_t&quotient, vvp_vector2_t&remainder);
 };
 
 extern bool operator >  (const vvp_vector2_t&, const vvp_vector2_t&);
@@ -678,6 +699,14 @@ extern vvp_vector2_t operator % (const vvp_vector2_t&, const vvp_vector2_t&);
 vvp_vector2_t pow(const vvp_vector2_t&, vvp_vector2_t&);
 extern vvp_vector4_t vector2_to_vector4(const vvp_vector2_t&, unsigned wid);
 
+/*
+ * Multiply the a and b word arrays and write the low rwords words of
+ * the product to res. Wide operands use Karatsuba multiplication.
+ */
+extern void multiply_words(unsigned long*res, unsigned rwords,
+			   const unsigned long*a, unsigned awords,
+			   const unsigned long*b, unsigned bwords);
+
 /* A c4string is of the form C4<...> where ... are bits. */
 extern bool c4string_test(const char*str);
 extern vvp_vector4_t c4string_to_vector4(const char*str);